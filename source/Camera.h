@@ -54,6 +54,12 @@ namespace dae
 			m_AspectRatio = aspectRatio;
 		}
 
+		void SetAspectRatio(float aspectRatio)
+		{
+			m_AspectRatio = aspectRatio;
+			CalculateProjectionMatrix();
+		}
+
 		void CalculateViewMatrix()
 		{
 			//ONB => invViewMatrix
@@ -101,6 +107,21 @@ namespace dae
 			//Mouse Input
 			ProcessMouseInput(); // NO DELTATIME NEEDED! Relative mouse movement is always to previous frame and thus already accounts for the time!
 
+			UpdateMatrices();
+		}
+
+		// Scripted cameras skip the input & place the camera directly
+		void SetPose(const Vector3& _origin, float pitch, float yaw)
+		{
+			origin = _origin;
+			totalPitch = pitch;
+			totalYaw = yaw;
+
+			UpdateMatrices();
+		}
+
+		void UpdateMatrices()
+		{
 			const Matrix finalRotation{ Matrix::CreateRotation(totalPitch, totalYaw, 0) };
 			forward = finalRotation.TransformVector(Vector3::UnitZ);
 			forward.Normalize();
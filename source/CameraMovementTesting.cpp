@@ -1,2 +1,167 @@
 #include "pch.h"
 #include "CameraMovementTesting.h"
+
+#include <fstream>
+#include <iomanip>
+
+#include "Renderer.h"
+#include "ConsoleColorCtrl.h"
+
+namespace dae
+{
+	// Loops around the vehicle (at z = 50): close up, both flanks & back to the start position
+	const std::vector<CameraMovementTesting::CameraKey> CameraMovementTesting::m_CameraPath
+	{
+		{ 0.f,	{ 0.f, 0.f, 0.f },		0.f,	0.f },
+		{ 2.f,	{ 0.f, 5.f, 25.f },		.1f,	0.f },
+		{ 4.f,	{ -25.f, 0.f, 25.f },	0.f,	.785f },
+		{ 6.f,	{ 25.f, 0.f, 25.f },	0.f,	-.785f },
+		{ 8.f,	{ 0.f, 0.f, 0.f },		0.f,	0.f }
+	};
+
+	CameraMovementTesting::CameraMovementTesting(const Settings& settings) :
+		m_Settings{ settings },
+		m_pRenderer{ new Renderer{ settings.width, settings.height } }
+	{
+		if (m_Settings.nrOfWorkers > 0) m_pRenderer->SetWorkerCount(m_Settings.nrOfWorkers);
+		m_pRenderer->SetStressMesh(SceneGenerator::Create(m_Settings.scene));
+		m_FrameTimes.reserve(m_Settings.nrOfMeasuredFrames);
+	}
+
+	CameraMovementTesting::~CameraMovementTesting()
+	{
+		SAFE_DELETE(m_pRenderer)
+	}
+
+	void CameraMovementTesting::Run()
+	{
+		m_FrameTimes.clear();
+		m_TotalStats = {};
+
+		// Frame index drives the time, so the path & the rotation don't depend on how fast the frames were
+		float time{};
+		for (int frameIdx{}; frameIdx < m_Settings.nrOfWarmUpFrames; ++frameIdx)
+		{
+			RenderFrame(time);
+			time += m_Settings.fixedDeltaTime;
+		}
+
+		const double msPerTick{ 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency()) };
+		for (int frameIdx{}; frameIdx < m_Settings.nrOfMeasuredFrames; ++frameIdx)
+		{
+			const uint64_t startTicks{ SDL_GetPerformanceCounter() };
+			RenderFrame(time);
+			m_FrameTimes.push_back(static_cast<float>(static_cast<double>(SDL_GetPerformanceCounter() - startTicks) * msPerTick));
+
+			m_TotalStats += m_pRenderer->GetRasterizerStats();
+			time += m_Settings.fixedDeltaTime;
+		}
+	}
+
+	void CameraMovementTesting::RenderFrame(float time)
+	{
+		const float pathDuration{ m_CameraPath.back().time };
+		const float pathTime{ fmodf(time, pathDuration) };
+
+		size_t keyIdx{};
+		while (keyIdx + 2 < m_CameraPath.size() && m_CameraPath[keyIdx + 1].time <= pathTime) ++keyIdx;
+
+		const CameraKey& from{ m_CameraPath[keyIdx] };
+		const CameraKey& to{ m_CameraPath[keyIdx + 1] };
+		const float factor{ (pathTime - from.time) / (to.time - from.time) };
+
+		const Vector3 origin{ Lerpf(from.origin.x, to.origin.x, factor), Lerpf(from.origin.y, to.origin.y, factor), Lerpf(from.origin.z, to.origin.z, factor) };
+		m_pRenderer->SetCameraPose(origin, Lerpf(from.pitch, to.pitch, factor), Lerpf(from.yaw, to.yaw, factor));
+
+		m_pRenderer->Update(m_Settings.fixedDeltaTime);
+		m_pRenderer->Render();
+	}
+
+	CameraMovementTesting::FrameSummary CameraMovementTesting::Summarize() const
+	{
+		FrameSummary summary{};
+		if (m_FrameTimes.empty()) return summary;
+
+		std::vector<float> sortedTimes{ m_FrameTimes };
+		std::sort(sortedTimes.begin(), sortedTimes.end());
+
+		// Nearest rank, same as the frame profiler
+		const int nrOfFrames{ static_cast<int>(sortedTimes.size()) };
+		const auto percentile = [&](float p) { return sortedTimes[std::min(static_cast<int>(p * nrOfFrames), nrOfFrames - 1)]; };
+
+		double totalTime{};
+		for (float frameTime : sortedTimes) totalTime += frameTime;
+
+		summary.min = sortedTimes.front();
+		summary.mean = static_cast<float>(totalTime / nrOfFrames);
+		summary.p95 = percentile(.95f);
+		summary.p99 = percentile(.99f);
+
+		// The profiler's window may be shorter than the measured frames, close enough for a breakdown
+		for (int stageIdx{}; stageIdx < static_cast<int>(summary.meanStageTimes.size()); ++stageIdx)
+		{
+			summary.meanStageTimes[stageIdx] = m_pRenderer->GetFrameProfiler()->GetMeanStageMs(static_cast<ProfileStage>(stageIdx), nrOfFrames);
+		}
+		return summary;
+	}
+
+	int CameraMovementTesting::GetWorkerCount() const
+	{
+		return m_pRenderer->GetWorkerCount();
+	}
+
+	void CameraMovementTesting::PrintSummary() const
+	{
+		const FrameSummary summary{ Summarize() };
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << std::fixed << std::setprecision(3)
+			<< "**(SOFTWARE) Benchmark, " << SceneGenerator::GetSceneName(m_Settings.scene) << ", " << m_Settings.width << 'x' << m_Settings.height << ", " << m_FrameTimes.size() << " frames [ms]\n"
+			<< "	MIN: " << summary.min << "	MEAN: " << summary.mean << "	P95: " << summary.p95 << "	P99: " << summary.p99
+			<< std::defaultfloat << std::endl;
+	}
+
+	bool CameraMovementTesting::WriteJson(const std::string& filePath) const
+	{
+		if (m_FrameTimes.empty()) return false;
+
+		std::ofstream file{ filePath };
+		if (!file) return false;
+
+		const FrameSummary summary{ Summarize() };
+		const RasterizerStats& stats{ m_TotalStats };
+
+		// Counters are totals over the measured frames
+		file << std::fixed << std::setprecision(4)
+			<< "{\n"
+			<< "\t\"scene\": \"" << SceneGenerator::GetSceneName(m_Settings.scene) << "\",\n"
+			<< "\t\"width\": " << m_Settings.width << ",\n"
+			<< "\t\"height\": " << m_Settings.height << ",\n"
+			<< "\t\"warmUpFrames\": " << m_Settings.nrOfWarmUpFrames << ",\n"
+			<< "\t\"measuredFrames\": " << m_FrameTimes.size() << ",\n"
+			<< "\t\"fixedDeltaTime\": " << m_Settings.fixedDeltaTime << ",\n"
+			<< "\t\"workers\": " << GetWorkerCount() << ",\n"
+			<< "\t\"msPerFrame\": { \"min\": " << summary.min << ", \"mean\": " << summary.mean
+			<< ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << " },\n"
+			<< "\t\"meanMsPerStage\": {";
+		for (int stageIdx{}; stageIdx < static_cast<int>(summary.meanStageTimes.size()); ++stageIdx)
+		{
+			file << (stageIdx == 0 ? " \"" : ", \"") << FrameProfiler::GetStageName(static_cast<ProfileStage>(stageIdx)) << "\": " << summary.meanStageTimes[stageIdx];
+		}
+		file << " },\n"
+			<< "\t\"rasterizerStats\": {\n"
+			<< "\t\t\"trianglesSubmitted\": " << stats.trianglesSubmitted << ",\n"
+			<< "\t\t\"frustumRejected\": " << stats.frustumRejected << ",\n"
+			<< "\t\t\"zeroArea\": " << stats.zeroArea << ",\n"
+			<< "\t\t\"backfaceCulled\": " << stats.backfaceCulled << ",\n"
+			<< "\t\t\"pixelsTested\": " << stats.pixelsTested << ",\n"
+			<< "\t\t\"pixelsCovered\": " << stats.pixelsCovered << ",\n"
+			<< "\t\t\"depthPasses\": " << stats.depthPasses << ",\n"
+			<< "\t\t\"shadedFragments\": " << stats.shadedFragments << ",\n"
+			<< "\t\t\"textureSamples\": " << stats.textureSamples << "\n"
+			<< "\t}\n"
+			<< "}\n";
+
+		return true;
+	}
+}
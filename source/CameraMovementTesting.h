@@ -1,10 +1,75 @@
 #pragma once
-class CameraMovementTesting
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Math.h"
+#include "RasterizerStats.h"
+#include "FrameProfiler.h"
+#include "SceneGenerator.h"
+
+namespace dae
 {
-public:
+	class Renderer;
+
+	// Scripted benchmark: replays a fixed camera path + mesh rotation through a headless software renderer with a fixed timestep,
+	// so two runs only differ in how long the frames took
+	class CameraMovementTesting final
+	{
+	public:
+		struct Settings
+		{
+			int width{ 640 };
+			int height{ 480 };
+			int nrOfWarmUpFrames{ 60 };
+			int nrOfMeasuredFrames{ 600 };
+			float fixedDeltaTime{ 1.f / 60.f };
+			int nrOfWorkers{};	// 0 keeps the renderer's default, one per hardware thread
+			StressScene scene{ StressScene::vehicle };
+		};
+
+		// Ms per frame over the measured frames
+		struct FrameSummary
+		{
+			float min{};
+			float mean{};
+			float p95{};
+			float p99{};
+			std::array<float, static_cast<int>(ProfileStage::ENUM_END)> meanStageTimes{};
+		};
+
+		explicit CameraMovementTesting(const Settings& settings);
+		~CameraMovementTesting();
+
+		CameraMovementTesting(const CameraMovementTesting& other) = delete;
+		CameraMovementTesting operator=(const CameraMovementTesting& other) = delete;
+		CameraMovementTesting(CameraMovementTesting&& other) = delete;
+		CameraMovementTesting operator=(CameraMovementTesting&& other) = delete;
+
+		void Run();
+		void PrintSummary() const;
+		bool WriteJson(const std::string& filePath) const;
+
+		FrameSummary Summarize() const;
+		int GetWorkerCount() const;
+
+	private:
+		struct CameraKey
+		{
+			float time;
+			Vector3 origin;
+			float pitch;
+			float yaw;
+		};
 
+		static const std::vector<CameraKey> m_CameraPath;
 
-private:
+		Settings m_Settings;
+		Renderer* m_pRenderer;
 
-};
+		std::vector<float> m_FrameTimes{};
+		RasterizerStats m_TotalStats{};
 
+		void RenderFrame(float time);
+	};
+}
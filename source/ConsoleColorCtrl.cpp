@@ -8,7 +8,13 @@ void ConsoleColorCtrl::SetConsoleHandle(HANDLE hConsole)
 
 void ConsoleColorCtrl::SetConsoleColor(WORD color)
 {
+#ifdef _WIN32
 	SetConsoleTextAttribute(m_hConsole, color);
+#else
+	// ANSI colors are numbered red 1, green 2, blue 4
+	const int ansiColor{ ((color & FOREGROUND_RED) ? 1 : 0) | ((color & FOREGROUND_GREEN) ? 2 : 0) | ((color & FOREGROUND_BLUE) ? 4 : 0) };
+	std::cout << "\x1b[" << 30 + ansiColor << 'm';
+#endif
 }
 
 ConsoleColorCtrl* ConsoleColorCtrl::GetInstance()
@@ -16,7 +22,9 @@ ConsoleColorCtrl* ConsoleColorCtrl::GetInstance()
 	if(m_pInstance == nullptr)
 	{
 		m_pInstance = new ConsoleColorCtrl;
+#ifdef _WIN32
 		m_pInstance->SetConsoleHandle(GetStdHandle(STD_OUTPUT_HANDLE));
+#endif
 	}
 	return m_pInstance;
 }
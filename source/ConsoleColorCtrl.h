@@ -1,6 +1,15 @@
 #pragma once
 #include "pch.h"
 
+#ifndef _WIN32
+// Same bit layout as the Windows console attributes, turned into ANSI escapes instead
+#define FOREGROUND_BLUE 0x1
+#define FOREGROUND_GREEN 0x2
+#define FOREGROUND_RED 0x4
+using WORD = uint16_t;
+using HANDLE = void*;
+#endif
+
 #define CNSL_GREEN FOREGROUND_GREEN
 #define CNSL_YELLOW (FOREGROUND_RED | FOREGROUND_GREEN)
 #define CNSL_PURPLE (FOREGROUND_BLUE | FOREGROUND_RED)
@@ -19,7 +28,7 @@ private:
 
 	void SetConsoleHandle(HANDLE hConsole);
 
-	HANDLE m_hConsole;
+	HANDLE m_hConsole{};
 
 	inline static ConsoleColorCtrl* m_pInstance{nullptr};
 };
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "DepthBuffer.h"
+
+namespace dae
+{
+	DepthBuffer::DepthBuffer(int width, int height) :
+		m_NrOfPixels{ width * height },
+		m_Capacity{ width * height },
+		m_pStorage{ new uint32_t[width * height] }
+	{
+	}
+
+	DepthBuffer::~DepthBuffer()
+	{
+		delete[] m_pStorage;
+	}
+
+	void DepthBuffer::Resize(int width, int height)
+	{
+		m_NrOfPixels = width * height;
+		if (m_NrOfPixels <= m_Capacity) return;
+
+		delete[] m_pStorage;
+		m_pStorage = new uint32_t[m_NrOfPixels];
+		m_Capacity = m_NrOfPixels;
+	}
+
+	void DepthBuffer::SetFormat(DepthFormat format, float nearPlane, float farPlane)
+	{
+		m_Format = format;
+		m_NearPlane = nearPlane;
+		m_FarPlane = farPlane;
+
+		// 1 - z of the projection matrix, rewritten as scale / w - bias
+		m_ReversedZScale = farPlane * nearPlane / (farPlane - nearPlane);
+		m_ReversedZBias = nearPlane / (farPlane - nearPlane);
+	}
+
+	void DepthBuffer::ClearRow(int firstPixelIdx, int nrOfPixels)
+	{
+		switch (m_Format)
+		{
+		case DepthFormat::float32:
+			std::fill_n(reinterpret_cast<float*>(m_pStorage) + firstPixelIdx, nrOfPixels, FLT_MAX);
+			break;
+
+		case DepthFormat::float32ReversedZ:
+			// Below 0, so fragments right on the far plane still pass
+			std::fill_n(reinterpret_cast<float*>(m_pStorage) + firstPixelIdx, nrOfPixels, -FLT_MAX);
+			break;
+
+		case DepthFormat::unorm24:
+			std::fill_n(m_pStorage + firstPixelIdx, nrOfPixels, 0u);
+			break;
+
+		case DepthFormat::unorm16:
+			std::fill_n(reinterpret_cast<uint16_t*>(m_pStorage) + firstPixelIdx, nrOfPixels, static_cast<uint16_t>(0));
+			break;
+
+		case DepthFormat::ENUM_END:
+			break;
+		}
+	}
+
+	const char* DepthBuffer::GetFormatName(DepthFormat format)
+	{
+		switch (format)
+		{
+		case DepthFormat::float32:			return "FLOAT32";
+		case DepthFormat::float32ReversedZ:	return "FLOAT32 REVERSED-Z";
+		case DepthFormat::unorm24:			return "UNORM24 REVERSED LINEAR (4 bytes)";
+		case DepthFormat::unorm16:			return "UNORM16 REVERSED LINEAR (2 bytes)";
+		case DepthFormat::ENUM_END:			break;
+		}
+
+		return "UNKNOWN";
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+namespace dae
+{
+	enum class DepthFormat
+	{
+		float32,			// Projected z, less test, FLT_MAX clear. The original format
+		float32ReversedZ,	// 1 at the near plane, 0 at the far plane, so float precision goes where z needs it
+		unorm24,			// Reversed linear view depth, integer compare. Precision only: it still takes a full 4 byte slot, no bandwidth saved
+		unorm16,			// Same in 2 bytes, the compact format: half the depth bandwidth
+		ENUM_END
+	};
+
+	// Software depth buffer in a selectable format, the reversed formats clear to their lowest value and keep the fragment with the greater value
+	class DepthBuffer
+	{
+	public:
+		DepthBuffer(int width, int height);
+		~DepthBuffer();
+
+		DepthBuffer(const DepthBuffer& other) = delete;
+		DepthBuffer operator=(const DepthBuffer& other) = delete;
+		DepthBuffer(DepthBuffer&& other) = delete;
+		DepthBuffer operator=(DepthBuffer&& other) = delete;
+
+		// Contents are garbage after a format change, until the pixels get cleared again
+		void SetFormat(DepthFormat format, float nearPlane, float farPlane);
+		DepthFormat GetFormat() const { return m_Format; }
+
+		// Keeps the storage when it's big enough, contents are garbage until cleared
+		void Resize(int width, int height);
+
+		void ClearRow(int firstPixelIdx, int nrOfPixels);
+
+		// zDepth is the projected depth, wDepth the view space depth. Stores the fragment and returns true when it's closer
+		bool TestAndWrite(int pixelIdx, float zDepth, float wDepth)
+		{
+			switch (m_Format)
+			{
+			case DepthFormat::float32:
+			{
+				float& depthBufferElement{ reinterpret_cast<float*>(m_pStorage)[pixelIdx] };
+				if (!(zDepth < depthBufferElement)) return false;
+				depthBufferElement = zDepth;
+				return true;
+			}
+			case DepthFormat::float32ReversedZ:
+			{
+				// Straight from w instead of 1 - z, that subtraction would throw away the precision this is all about
+				const float reversedDepth{ m_ReversedZScale / wDepth - m_ReversedZBias };
+				float& depthBufferElement{ reinterpret_cast<float*>(m_pStorage)[pixelIdx] };
+				if (!(reversedDepth > depthBufferElement)) return false;
+				depthBufferElement = reversedDepth;
+				return true;
+			}
+			case DepthFormat::unorm24:
+			{
+				const uint32_t reversedDepth{ Quantize(wDepth, m_Unorm24Max) };
+				uint32_t& depthBufferElement{ m_pStorage[pixelIdx] };
+				if (reversedDepth <= depthBufferElement) return false;
+				depthBufferElement = reversedDepth;
+				return true;
+			}
+			case DepthFormat::unorm16:
+			{
+				const uint16_t reversedDepth{ static_cast<uint16_t>(Quantize(wDepth, m_Unorm16Max)) };
+				uint16_t& depthBufferElement{ reinterpret_cast<uint16_t*>(m_pStorage)[pixelIdx] };
+				if (reversedDepth <= depthBufferElement) return false;
+				depthBufferElement = reversedDepth;
+				return true;
+			}
+			case DepthFormat::ENUM_END:
+				break;
+			}
+
+			return false;
+		}
+
+		static const char* GetFormatName(DepthFormat format);
+
+	private:
+		static constexpr uint32_t m_Unorm24Max{ (1u << 24) - 1 };
+		static constexpr uint32_t m_Unorm16Max{ (1u << 16) - 1 };
+
+		int m_NrOfPixels{};
+		int m_Capacity{};
+		uint32_t* m_pStorage{};	// 4 bytes per pixel for float32 & unorm24, the 16 bit format only uses the first half
+
+		DepthFormat m_Format{ DepthFormat::float32 };
+		float m_NearPlane{ .1f };
+		float m_FarPlane{ 100.f };
+		float m_ReversedZScale{};
+		float m_ReversedZBias{};
+
+		// Linear in view depth, so the steps are evenly spread between near & far. 0 is reserved for cleared pixels
+		uint32_t Quantize(float wDepth, uint32_t maxValue) const
+		{
+			const float reversedLinearDepth{ std::clamp((m_FarPlane - wDepth) / (m_FarPlane - m_NearPlane), 0.f, 1.f) };
+			return 1 + static_cast<uint32_t>(reversedLinearDepth * static_cast<float>(maxValue - 1) + .5f);
+		}
+	};
+}
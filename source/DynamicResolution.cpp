@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "DynamicResolution.h"
+
+namespace dae
+{
+	DynamicResolution::DynamicResolution(const Settings& settings) :
+		m_Settings{ settings },
+		m_Scale{ settings.maxScale }
+	{
+		m_FrameTimes.reserve(m_Settings.nrOfFramesToAverage);
+	}
+
+	float DynamicResolution::Update(float frameMs)
+	{
+		if (m_NrOfSettleFramesLeft > 0)
+		{
+			--m_NrOfSettleFramesLeft;
+			return m_Scale;
+		}
+
+		m_FrameTimes.push_back(frameMs);
+		if (static_cast<int>(m_FrameTimes.size()) < m_Settings.nrOfFramesToAverage) return m_Scale;
+
+		double totalMs{};
+		for (float frameTime : m_FrameTimes) totalMs += frameTime;
+		const float meanMs{ static_cast<float>(totalMs / m_FrameTimes.size()) };
+		m_FrameTimes.clear();
+
+		// Cost follows the pixel count, which goes with the square of the scale
+		float newScale{ m_Scale };
+		if (meanMs > m_Settings.targetMs * m_Settings.upperBand)
+		{
+			newScale = SnapScale(m_Scale * sqrtf(m_Settings.targetMs / meanMs));
+		}
+		else if (meanMs < m_Settings.targetMs * m_Settings.lowerBand)
+		{
+			// Up one step at a time, missing the budget again costs more than a few frames below the best size
+			newScale = SnapScale(std::min(m_Scale * sqrtf(m_Settings.targetMs / meanMs), m_Scale + m_Settings.scaleStep));
+		}
+
+		if (newScale != m_Scale)
+		{
+			m_Scale = newScale;
+			m_NrOfSettleFramesLeft = m_Settings.nrOfSettleFrames;
+		}
+		return m_Scale;
+	}
+
+	void DynamicResolution::Reset(float scale)
+	{
+		m_Scale = std::clamp(scale, m_Settings.minScale, m_Settings.maxScale);
+		m_NrOfSettleFramesLeft = 0;
+		m_FrameTimes.clear();
+	}
+
+	float DynamicResolution::SnapScale(float scale) const
+	{
+		// Rounds down, going over the budget is what this is here to prevent. The epsilon keeps exact multiples from dropping a step
+		const float snappedScale{ floorf(scale / m_Settings.scaleStep + .001f) * m_Settings.scaleStep };
+		return std::clamp(snappedScale, m_Settings.minScale, m_Settings.maxScale);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+
+namespace dae
+{
+	// Picks the software render scale that holds a frame time budget, fed with one frame time per frame
+	// Only reacts once the mean over a window of frames leaves a band around the target, and skips the first frames after a change
+	// so the new size gets measured instead of the reallocation
+	class DynamicResolution final
+	{
+	public:
+		struct Settings
+		{
+			float targetMs{ 16.67f };
+			float minScale{ .5f };
+			float maxScale{ 1.f };
+			float scaleStep{ .05f };		// Scales snap to multiples of this, small corrections don't reallocate every window
+			float upperBand{ 1.05f };		// Scale goes down once the mean frame time is above target * upperBand
+			float lowerBand{ .8f };			// and up once it's below target * lowerBand
+			int nrOfFramesToAverage{ 8 };
+			int nrOfSettleFrames{ 4 };
+		};
+
+		explicit DynamicResolution(const Settings& settings);
+		~DynamicResolution() = default;
+
+		DynamicResolution(const DynamicResolution& other) = delete;
+		DynamicResolution operator=(const DynamicResolution& other) = delete;
+		DynamicResolution(DynamicResolution&& other) = delete;
+		DynamicResolution operator=(DynamicResolution&& other) = delete;
+
+		// Returns the scale the next frame should render at
+		float Update(float frameMs);
+		void Reset(float scale = 1.f);
+
+		void SetTargetMs(float targetMs) { m_Settings.targetMs = targetMs; }
+		const Settings& GetSettings() const { return m_Settings; }
+		float GetScale() const { return m_Scale; }
+
+	private:
+		Settings m_Settings;
+		float m_Scale{ 1.f };
+		int m_NrOfSettleFramesLeft{};
+		std::vector<float> m_FrameTimes{};
+
+		float SnapScale(float scale) const;
+	};
+}
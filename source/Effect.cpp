@@ -4,6 +4,7 @@
 
 #include "Texture.h"
 
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	Effect::Effect(ID3D11Device* pDevice, const std::wstring& fxPath, const LPCSTR& technique)
@@ -191,6 +192,7 @@ namespace dae
 		return pEffect;
 	}
 }
+#endif
 
 
 
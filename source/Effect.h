@@ -11,6 +11,7 @@ namespace dae
 		PartCov
 	};
 
+#ifndef DISABLE_DIRECTX
 	class Effect
 	{
 	public:
@@ -58,6 +59,7 @@ namespace dae
 		void ReleaseMatrices();
 		void ReleaseTechniques();
 	};
+#endif
 }
 
 
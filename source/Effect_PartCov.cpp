@@ -3,6 +3,7 @@
 
 #include "Texture.h"
 
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	Effect_PartCov::Effect_PartCov(ID3D11Device* pDevice)
@@ -35,3 +36,4 @@ namespace dae
 		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 	}
 }
+#endif
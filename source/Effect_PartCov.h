@@ -1,5 +1,6 @@
 #pragma once
 #include "Effect.h"
+#ifndef DISABLE_DIRECTX
 namespace dae {
 	class Effect_PartCov : public Effect
 	{
@@ -14,4 +15,5 @@ namespace dae {
 		virtual void InitializeVertexDesc(D3D11_INPUT_ELEMENT_DESC* vertexDesc) override;
 	};
 }
+#endif
 
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Effect_PosCol.h"
 
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	Effect_PosCol::Effect_PosCol(ID3D11Device* pDevice)
@@ -31,4 +32,5 @@ namespace dae
 		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 	}
 }
+#endif
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Effect.h"
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	class Effect_PosCol : public Effect
@@ -18,4 +19,5 @@ namespace dae
 	private:
 		virtual void InitializeVertexDesc(D3D11_INPUT_ELEMENT_DESC* vertexDesc) override;
 	};
-}
\ No newline at end of file
+}
+#endif
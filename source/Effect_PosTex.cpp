@@ -5,6 +5,7 @@
 #include "Texture.h"
 #include "Renderer.h"
 
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	Effect_PosTex::Effect_PosTex(ID3D11Device* pDevice)
@@ -25,6 +26,8 @@ namespace dae
 	{
 		if (m_pShadingMode) m_pShadingMode->Release();
 		if (m_pUsingNormalMap) m_pUsingNormalMap->Release();
+		if (m_pLightDirection) m_pLightDirection->Release();
+		if (m_pLightIntensity) m_pLightIntensity->Release();
 	}
 
 	void Effect_PosTex::SetCullingMode(CullingMode cullingMode)
@@ -62,6 +65,12 @@ namespace dae
 		m_pShadingMode->SetInt(shadingMode);
 	}
 
+	void Effect_PosTex::SetKeyLight(const Vector3& direction, float intensity)
+	{
+		m_pLightDirection->SetFloatVector(reinterpret_cast<const float*>(&direction));
+		m_pLightIntensity->SetFloat(intensity);
+	}
+
 	EffectType Effect_PosTex::GetFxType()
 	{
 		return EffectType::PosTex;
@@ -97,5 +106,9 @@ namespace dae
 
 		m_pUsingNormalMap = m_pEffect->GetVariableBySemantic("USENORMALMAP")->AsScalar();
 		m_pUsingNormalMap->SetBool(true);
+
+		m_pLightDirection = m_pEffect->GetVariableByName("gLightDirection")->AsVector();
+		m_pLightIntensity = m_pEffect->GetVariableByName("gLightIntensity")->AsScalar();
 	}
-}
\ No newline at end of file
+}
+#endif
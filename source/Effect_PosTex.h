@@ -1,6 +1,7 @@
 #pragma once
 #include "Effect.h"
 
+#ifndef DISABLE_DIRECTX
 namespace dae
 {
 	enum class CullingMode;
@@ -21,6 +22,7 @@ namespace dae
 		void CycleFilterTechnique();
 		void SetCullingMode(CullingMode cullingMode);
 		void SetShadingMode(int shadingMode);
+		void SetKeyLight(const Vector3& direction, float intensity);
 		EffectType GetFxType() override;
 
 	private:
@@ -29,8 +31,11 @@ namespace dae
 		ID3DX11EffectScalarVariable* m_pShadingMode;
 		ID3DX11EffectScalarVariable* m_pUsingNormalMap;
 		ID3DX11EffectScalarVariable* m_pShininess;
+		ID3DX11EffectVectorVariable* m_pLightDirection;
+		ID3DX11EffectScalarVariable* m_pLightIntensity;
 
 		void InitializeVertexDesc(D3D11_INPUT_ELEMENT_DESC* vertexDesc) override;
 		void InitializePrimitives();
 	};
 }
+#endif
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "FrameProfiler.h"
+#include <fstream>
+#include <iomanip>
+#include <cassert>
+
+namespace dae
+{
+	FrameProfiler::FrameProfiler(int nrOfFramesInWindow, int nrOfFramesKept) :
+		m_MsPerTick{ 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency()) },
+		m_NrOfFramesInWindow{ nrOfFramesInWindow },
+		m_NrOfFramesKept{ std::max(nrOfFramesKept, nrOfFramesInWindow) }
+	{
+		m_Frames.reserve(m_NrOfFramesKept);
+	}
+
+	void FrameProfiler::BeginFrame()
+	{
+		m_IsInFrame = true;
+		m_FrameThreadId = std::this_thread::get_id();
+		m_NrOfOpenStages = 0;
+		std::fill_n(m_CurrentFrameTicks, m_NrOfStages, 0ull);
+		m_FrameStartTicks = SDL_GetPerformanceCounter();
+	}
+
+	void FrameProfiler::EndFrame()
+	{
+		if (!m_IsInFrame) return;
+		m_IsInFrame = false;
+
+		FrameTimes frame{};
+		for (int stageIdx{}; stageIdx < m_NrOfStages; ++stageIdx)
+		{
+			frame[stageIdx] = static_cast<float>(m_CurrentFrameTicks[stageIdx] * m_MsPerTick);
+		}
+		frame[m_NrOfStages] = static_cast<float>((SDL_GetPerformanceCounter() - m_FrameStartTicks) * m_MsPerTick);
+
+		if (static_cast<int>(m_Frames.size()) < m_NrOfFramesKept) m_Frames.push_back(frame);
+		else m_Frames[m_NextFrameIdx] = frame;
+		m_NextFrameIdx = (m_NextFrameIdx + 1) % m_NrOfFramesKept;
+		++m_NrOfEndedFrames;
+	}
+
+	void FrameProfiler::BeginStage(ProfileStage stage)
+	{
+		if (!IsFrameThread()) return;
+
+		assert(m_NrOfOpenStages < m_MaxStageDepth && "FrameProfiler: stages nested too deep");
+		m_OpenStages[m_NrOfOpenStages++] = { stage, SDL_GetPerformanceCounter(), 0 };
+	}
+
+	void FrameProfiler::EndStage()
+	{
+		if (!IsFrameThread()) return;
+
+		assert(m_NrOfOpenStages > 0 && "FrameProfiler: EndStage without BeginStage");
+		const OpenStage& openStage{ m_OpenStages[--m_NrOfOpenStages] };
+
+		const uint64_t totalTicks{ SDL_GetPerformanceCounter() - openStage.startTicks };
+		// Sampled children are estimates, so they can overshoot a little
+		const uint64_t exclusiveTicks{ totalTicks > openStage.childTicks ? totalTicks - openStage.childTicks : 0 };
+
+		m_CurrentFrameTicks[static_cast<int>(openStage.stage)] += exclusiveTicks;
+		if (m_NrOfOpenStages > 0) m_OpenStages[m_NrOfOpenStages - 1].childTicks += totalTicks;
+	}
+
+	void FrameProfiler::AddWorkerTime(ProfileStage stage, uint64_t ticks, int nrOfWorkers)
+	{
+		if (!IsFrameThread()) return;
+
+		const uint64_t averageTicks{ ticks / static_cast<uint64_t>(std::max(nrOfWorkers, 1)) };
+
+		m_CurrentFrameTicks[static_cast<int>(stage)] += averageTicks;
+		if (m_NrOfOpenStages > 0) m_OpenStages[m_NrOfOpenStages - 1].childTicks += averageTicks;
+	}
+
+	void FrameProfiler::PrintPercentiles() const
+	{
+		const int nrOfFrames{ std::min(static_cast<int>(m_Frames.size()), m_NrOfFramesInWindow) };
+		std::cout << "**(SOFTWARE) Frame Profile, last " << nrOfFrames << " frames [ms]\n";
+		if (nrOfFrames == 0) return;
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< "	" << std::left << std::setw(18) << "STAGE" << std::right << std::setw(10) << "P50" << std::setw(10) << "P95" << std::setw(10) << "P99" << '\n';
+
+		std::vector<float> stageTimes(nrOfFrames);
+		for (int stageIdx{}; stageIdx <= m_NrOfStages; ++stageIdx)
+		{
+			for (int frameIdx{}; frameIdx < nrOfFrames; ++frameIdx)
+			{
+				stageTimes[frameIdx] = GetKeptFrame(static_cast<int>(m_Frames.size()) - nrOfFrames + frameIdx)[stageIdx];
+			}
+			std::sort(stageTimes.begin(), stageTimes.end());
+
+			// Nearest rank
+			const auto percentile = [&](float p) { return stageTimes[std::min(static_cast<int>(p * nrOfFrames), nrOfFrames - 1)]; };
+
+			const char* stageName{ stageIdx < m_NrOfStages ? GetStageName(static_cast<ProfileStage>(stageIdx)) : "FRAME" };
+			std::cout << "	" << std::left << std::setw(18) << stageName << std::right
+				<< std::setw(10) << percentile(.5f) << std::setw(10) << percentile(.95f) << std::setw(10) << percentile(.99f) << '\n';
+		}
+		std::cout << std::defaultfloat << std::flush;
+	}
+
+	float FrameProfiler::GetMeanStageMs(ProfileStage stage, int nrOfLastFrames) const
+	{
+		const int nrOfFrames{ std::min(static_cast<int>(m_Frames.size()), nrOfLastFrames) };
+		if (nrOfFrames == 0) return 0.f;
+
+		double totalTime{};
+		for (int frameIdx{ static_cast<int>(m_Frames.size()) - nrOfFrames }; frameIdx < static_cast<int>(m_Frames.size()); ++frameIdx)
+		{
+			totalTime += GetKeptFrame(frameIdx)[static_cast<int>(stage)];
+		}
+		return static_cast<float>(totalTime / nrOfFrames);
+	}
+
+	bool FrameProfiler::WriteCsv(const std::string& filePath) const
+	{
+		if (m_Frames.empty()) return false;
+
+		std::ofstream file{ filePath };
+		if (!file) return false;
+
+		file << "frame";
+		for (int stageIdx{}; stageIdx < m_NrOfStages; ++stageIdx)
+		{
+			file << ',' << GetStageName(static_cast<ProfileStage>(stageIdx));
+		}
+		file << ",FRAME\n";
+
+		// Frame numbers count from the first frame ever, so a trimmed CSV still lines up with the session
+		const uint64_t firstFrameNr{ m_NrOfEndedFrames - m_Frames.size() };
+		for (int frameIdx{}; frameIdx < static_cast<int>(m_Frames.size()); ++frameIdx)
+		{
+			file << firstFrameNr + frameIdx;
+			for (float stageTime : GetKeptFrame(frameIdx))
+			{
+				file << ',' << stageTime;
+			}
+			file << '\n';
+		}
+
+		return true;
+	}
+
+	const char* FrameProfiler::GetStageName(ProfileStage stage)
+	{
+		switch (stage)
+		{
+		case ProfileStage::vertexTransform:	return "VERTEX_TRANSFORM";
+		case ProfileStage::binning:			return "BINNING";
+		case ProfileStage::clear:			return "CLEAR";
+		case ProfileStage::rasterization:	return "RASTERIZATION";
+		case ProfileStage::shading:			return "SHADING";
+		case ProfileStage::msaaResolve:		return "MSAA_RESOLVE";
+		case ProfileStage::antiAliasing:	return "ANTI_ALIASING";
+		case ProfileStage::present:			return "PRESENT";
+		case ProfileStage::ENUM_END:		break;
+		}
+
+		return "UNKNOWN";
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <string>
+#include <thread>
+
+namespace dae
+{
+	enum class ProfileStage
+	{
+		vertexTransform,	// Mesh vertices to projection space
+		binning,			// Everything that sorts work into tiles, light culling for now
+		clear,				// Lazy tile clears & the resolve of untouched tiles
+		rasterization,		// Triangle setup & traversal, without the shading & clears that happen inside it
+		shading,			// Per fragment shading, sampled on every worker & averaged over them
+		msaaResolve,		// Averaging the MSAA samples of finished bins, on every worker & averaged over them. The extra sample tests stay in rasterization
+		antiAliasing,		// Post process AA pass over the finished frame
+		present,			// Blit + window update, or waiting on the present thread
+		ENUM_END
+	};
+
+	// Per stage timings of software frames, with rolling percentiles over the last frames and a CSV of the frames that are kept
+	// Keeps a fixed number of frames in a ring, so long sessions don't grow & the summaries cost the same every time
+	// Only the thread that began the frame records stages, time the raster workers spend in one gets handed over through AddWorkerTime
+	class FrameProfiler
+	{
+	public:
+		explicit FrameProfiler(int nrOfFramesInWindow = 240, int nrOfFramesKept = 4096);
+		~FrameProfiler() = default;
+
+		FrameProfiler(const FrameProfiler& other) = delete;
+		FrameProfiler operator=(const FrameProfiler& other) = delete;
+		FrameProfiler(FrameProfiler&& other) = delete;
+		FrameProfiler operator=(FrameProfiler&& other) = delete;
+
+		void BeginFrame();
+		void EndFrame();
+
+		// Stages can nest, the outer one only keeps its exclusive time
+		void BeginStage(ProfileStage stage);
+		void EndStage();
+
+		// Stages that run per fragment are too fine grained to time every call, only one in m_SampleRate gets timed & scaled up.
+		// Every worker counts into its own counter & ticks, see SampledProfileScope
+		static bool ShouldSample(uint32_t& sampleCounter) { return (sampleCounter++ % m_SampleRate) == 0; }
+		static uint64_t EstimateTicks(uint64_t sampledTicks) { return sampledTicks * m_SampleRate; }
+
+		// Summed time of all workers once they're done, averaged over them so it's a share of the open stage like any other.
+		// Workers waiting on the slowest one stay in the open stage
+		void AddWorkerTime(ProfileStage stage, uint64_t ticks, int nrOfWorkers);
+
+		void PrintPercentiles() const;
+		float GetMeanStageMs(ProfileStage stage, int nrOfLastFrames) const;
+		float GetLastFrameMs() const { return m_Frames.empty() ? 0.f : GetKeptFrame(static_cast<int>(m_Frames.size()) - 1)[m_NrOfStages]; }
+		bool WriteCsv(const std::string& filePath) const;
+
+		static const char* GetStageName(ProfileStage stage);
+
+	private:
+		bool IsFrameThread() const { return std::this_thread::get_id() == m_FrameThreadId; }
+
+		static constexpr int m_NrOfStages{ static_cast<int>(ProfileStage::ENUM_END) };
+		static constexpr int m_MaxStageDepth{ 8 };
+		static constexpr uint32_t m_SampleRate{ 16 };
+
+		struct OpenStage
+		{
+			ProfileStage stage{};
+			uint64_t startTicks{};
+			uint64_t childTicks{};
+		};
+
+		// Milliseconds per stage, last element is the whole frame
+		using FrameTimes = std::array<float, m_NrOfStages + 1>;
+
+		double m_MsPerTick{};
+		int m_NrOfFramesInWindow{};
+		int m_NrOfFramesKept{};
+
+		bool m_IsInFrame{ false };
+		std::thread::id m_FrameThreadId{ std::this_thread::get_id() };
+		uint64_t m_FrameStartTicks{};
+		uint64_t m_CurrentFrameTicks[m_NrOfStages]{};
+
+		OpenStage m_OpenStages[m_MaxStageDepth]{};
+		int m_NrOfOpenStages{};
+
+		std::vector<FrameTimes> m_Frames{};	// Ring once it holds m_NrOfFramesKept frames
+		int m_NextFrameIdx{};				// Slot the next frame goes in: the end while filling up, the oldest frame once full
+		uint64_t m_NrOfEndedFrames{};
+
+		// 0 is the oldest kept frame
+		const FrameTimes& GetKeptFrame(int keptFrameIdx) const { return m_Frames[(m_NextFrameIdx + keptFrameIdx) % m_Frames.size()]; }
+	};
+
+	// Times the enclosing scope as a stage
+	class ProfileScope final
+	{
+	public:
+		ProfileScope(FrameProfiler* pProfiler, ProfileStage stage) : m_pProfiler{ pProfiler } { m_pProfiler->BeginStage(stage); }
+		~ProfileScope() { m_pProfiler->EndStage(); }
+
+		ProfileScope(const ProfileScope& other) = delete;
+		ProfileScope operator=(const ProfileScope& other) = delete;
+		ProfileScope(ProfileScope&& other) = delete;
+		ProfileScope operator=(ProfileScope&& other) = delete;
+
+	private:
+		FrameProfiler* m_pProfiler;
+	};
+
+	// Same, for per fragment stages on any worker, only reads the clock when this call got sampled.
+	// The counter & ticks belong to the calling worker, so workers never share them
+	class SampledProfileScope final
+	{
+	public:
+		SampledProfileScope(uint32_t& sampleCounter, uint64_t& ticks) :
+			m_Ticks{ ticks },
+			m_IsSampled{ FrameProfiler::ShouldSample(sampleCounter) },
+			m_StartTicks{ m_IsSampled ? SDL_GetPerformanceCounter() : 0 }
+		{
+		}
+		~SampledProfileScope() { if (m_IsSampled) m_Ticks += FrameProfiler::EstimateTicks(SDL_GetPerformanceCounter() - m_StartTicks); }
+
+		SampledProfileScope(const SampledProfileScope& other) = delete;
+		SampledProfileScope operator=(const SampledProfileScope& other) = delete;
+		SampledProfileScope(SampledProfileScope&& other) = delete;
+		SampledProfileScope operator=(SampledProfileScope&& other) = delete;
+
+	private:
+		uint64_t& m_Ticks;
+		bool m_IsSampled;
+		uint64_t m_StartTicks;
+	};
+}
@@ -0,0 +1,30 @@
+#include "pch.h"
+#include "FramebufferWriter.h"
+#include <cassert>
+
+namespace dae
+{
+	bool FramebufferWriter::IsSupported(const SDL_PixelFormat* pFormat)
+	{
+		return pFormat->BytesPerPixel == 4
+			&& pFormat->Rloss == 0 && pFormat->Gloss == 0 && pFormat->Bloss == 0
+			&& pFormat->Rshift % 8 == 0 && pFormat->Gshift % 8 == 0 && pFormat->Bshift % 8 == 0;
+	}
+
+	void FramebufferWriter::Resolve(const SDL_PixelFormat* pFormat)
+	{
+		// Which is what the back buffer and window surfaces use
+		assert(IsSupported(pFormat) && "FramebufferWriter: unsupported pixel format");
+
+		m_RedShift = pFormat->Rshift;
+		m_GreenShift = pFormat->Gshift;
+		m_BlueShift = pFormat->Bshift;
+		m_AlphaMask = pFormat->Amask;
+
+		// The byte nobody claims holds alpha (or padding)
+		for (int& channel : m_ChannelAtByte) channel = alpha;
+		m_ChannelAtByte[m_RedShift / 8] = red;
+		m_ChannelAtByte[m_GreenShift / 8] = green;
+		m_ChannelAtByte[m_BlueShift / 8] = blue;
+	}
+}
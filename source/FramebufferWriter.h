@@ -0,0 +1,105 @@
+#pragma once
+#include "SimdMath.h"
+
+struct SDL_PixelFormat;
+
+namespace dae
+{
+	// Packs shaded colors straight into a 32 bit surface, so the inner loop never has to go through SDL_MapRGB
+	// Resolve once per frame for the surface that gets written to
+	class FramebufferWriter
+	{
+	public:
+		FramebufferWriter() = default;
+		~FramebufferWriter() = default;
+
+		FramebufferWriter(const FramebufferWriter& other) = delete;
+		FramebufferWriter operator=(const FramebufferWriter& other) = delete;
+		FramebufferWriter(FramebufferWriter&& other) = delete;
+		FramebufferWriter operator=(FramebufferWriter&& other) = delete;
+
+		// Only 8 bits per channel, 32 bit formats with byte aligned channels
+		static bool IsSupported(const SDL_PixelFormat* pFormat);
+		void Resolve(const SDL_PixelFormat* pFormat);
+
+		// Same result as MaxToOne + SDL_MapRGB
+		uint32_t Pack(ColorRGB color) const
+		{
+			color.MaxToOne();
+
+			return static_cast<uint32_t>(static_cast<uint8_t>(color.r * 255)) << m_RedShift
+				 | static_cast<uint32_t>(static_cast<uint8_t>(color.g * 255)) << m_GreenShift
+				 | static_cast<uint32_t>(static_cast<uint8_t>(color.b * 255)) << m_BlueShift
+				 | m_AlphaMask;
+		}
+
+		// Four pixels at once, lane i ends up in 32 bit element i
+		__m128i PackX4(const ColorRGBX4& color) const
+		{
+			// MaxToOne, lanes with a component above 1 get divided by it (divide first, so the rounding matches Pack)
+			const FloatX4 maxValue{ FloatX4::Max(color.r, FloatX4::Max(color.g, color.b)) };
+			const FloatX4 divisor{ FloatX4::Select(maxValue > 1.f, maxValue, FloatX4{ 1.f }) };
+
+			// Truncate like the static_cast, the saturating packs take care of anything below 0
+			const __m128i channels[4]
+			{
+				_mm_cvttps_epi32((color.r / divisor * 255.f).v),
+				_mm_cvttps_epi32((color.g / divisor * 255.f).v),
+				_mm_cvttps_epi32((color.b / divisor * 255.f).v),
+				_mm_set1_epi32(m_AlphaMask ? 255 : 0)
+			};
+
+			// Planar bytes, in the order they appear in memory: b0 b1 b2 b3 | b0 b1 b2 b3 | ...
+			const __m128i planar{ _mm_packus_epi16(
+				_mm_packs_epi32(channels[m_ChannelAtByte[0]], channels[m_ChannelAtByte[1]]),
+				_mm_packs_epi32(channels[m_ChannelAtByte[2]], channels[m_ChannelAtByte[3]])) };
+
+			// Two interleave rounds turn the 4x4 byte matrix around, pixel per 32 bit element
+			const __m128i interleaved{ _mm_unpacklo_epi8(planar, _mm_srli_si128(planar, 8)) };
+			return _mm_unpacklo_epi8(interleaved, _mm_srli_si128(interleaved, 8));
+		}
+
+		// Lanes: (px, py), (px + 1, py), (px, py + 1), (px + 1, py + 1), only the lanes in the mask get written
+		void WriteQuad(uint32_t* pPixels, int width, int px, int py, const ColorRGBX4& color, int mask) const
+		{
+			const __m128i packed{ PackX4(color) };
+			uint32_t* pTopRow{ pPixels + px + py * width };
+			uint32_t* pBottomRow{ pTopRow + width };
+
+			// Full rows go out as a single 64 bit store
+			if ((mask & 0b0011) == 0b0011)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(pTopRow), packed);
+				mask &= ~0b0011;
+			}
+			if ((mask & 0b1100) == 0b1100)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(pBottomRow), _mm_srli_si128(packed, 8));
+				mask &= ~0b1100;
+			}
+			if (mask == 0) return;
+
+			alignas(16) uint32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), packed);
+			if (mask & 0b0001) pTopRow[0] = lanes[0];
+			if (mask & 0b0010) pTopRow[1] = lanes[1];
+			if (mask & 0b0100) pBottomRow[0] = lanes[2];
+			if (mask & 0b1000) pBottomRow[1] = lanes[3];
+		}
+
+	private:
+		enum Channel
+		{
+			red,
+			green,
+			blue,
+			alpha	// Also used for the padding byte of formats without alpha
+		};
+
+		int m_RedShift{ 16 };
+		int m_GreenShift{ 8 };
+		int m_BlueShift{};
+		uint32_t m_AlphaMask{};
+		int m_ChannelAtByte[4]{ blue, green, red, alpha };
+	};
+}
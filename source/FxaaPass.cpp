@@ -0,0 +1,155 @@
+#include "pch.h"
+#include "FxaaPass.h"
+#include "WorkerPool.h"
+
+#include <emmintrin.h>
+#include <cstring>
+
+namespace dae
+{
+	void FxaaPass::Apply(uint32_t* pPixels, int width, int height, const SDL_PixelFormat* pFormat, WorkerPool* pWorkerPool)
+	{
+		if (width <= 0 || height <= 0) return;
+
+		// Every pixel reads its neighbours as they were before the pass, grows only so resizes don't reallocate every frame
+		const size_t nrOfPixels{ static_cast<size_t>(width) * height };
+		if (m_Source.size() < nrOfPixels) m_Source.resize(nrOfPixels);
+		memcpy(m_Source.data(), pPixels, nrOfPixels * sizeof(uint32_t));
+
+		m_RedShift = _mm_cvtsi32_si128(pFormat->Rshift);
+		m_GreenShift = _mm_cvtsi32_si128(pFormat->Gshift);
+		m_BlueShift = _mm_cvtsi32_si128(pFormat->Bshift);
+
+		const int nrOfJobs{ (height + m_NrOfRowsPerJob - 1) / m_NrOfRowsPerJob };
+		pWorkerPool->Run(nrOfJobs, [this, pPixels, width, height](int jobIdx, int)
+			{
+				const int firstRow{ jobIdx * m_NrOfRowsPerJob };
+				ApplyRows(pPixels, width, height, firstRow, std::min(firstRow + m_NrOfRowsPerJob, height));
+			});
+	}
+
+	void FxaaPass::ApplyRows(uint32_t* pPixels, int width, int height, int firstRow, int endRow) const
+	{
+		const uint32_t* pSource{ m_Source.data() };
+
+		for (int y{ firstRow }; y < endRow; ++y)
+		{
+			// Edges of the frame clamp to the nearest pixel
+			const uint32_t* pRow{ pSource + y * width };
+			const uint32_t* pNorth{ pSource + std::max(y - 1, 0) * width };
+			const uint32_t* pSouth{ pSource + std::min(y + 1, height - 1) * width };
+			uint32_t* pOut{ pPixels + y * width };
+
+			// Gathers four pixels from x with clamped neighbours, only writes the ones before endX
+			const auto blendGathered = [&](int x, int endX)
+			{
+				int columns[6]{};
+				for (int i{}; i < 6; ++i) columns[i] = std::clamp(x + i - 1, 0, width - 1);
+
+				const auto gather = [&columns](const uint32_t* pLine, int offset)
+				{
+					return _mm_setr_epi32(static_cast<int>(pLine[columns[offset]]), static_cast<int>(pLine[columns[offset + 1]]),
+						static_cast<int>(pLine[columns[offset + 2]]), static_cast<int>(pLine[columns[offset + 3]]));
+				};
+
+				alignas(16) uint32_t result[4]{};
+				_mm_store_si128(reinterpret_cast<__m128i*>(result), BlendX4(gather(pRow, 1), gather(pNorth, 1), gather(pSouth, 1), gather(pRow, 0), gather(pRow, 2)));
+				for (int i{}; i < 4 && x + i < endX; ++i) pOut[x + i] = result[i];
+			};
+
+			blendGathered(0, 1);
+
+			// Inner pixels, the neighbours are plain unaligned loads one pixel over
+			int x{ 1 };
+			for (; x + 4 <= width - 1; x += 4)
+			{
+				const __m128i center{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + x)) };
+				const __m128i north{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pNorth + x)) };
+				const __m128i south{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSouth + x)) };
+				const __m128i west{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + x - 1)) };
+				const __m128i east{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + x + 1)) };
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + x), BlendX4(center, north, south, west, east));
+			}
+
+			for (; x < width; x += 4) blendGathered(x, width);
+		}
+	}
+
+	__m128i FxaaPass::BlendX4(const __m128i& center, const __m128i& north, const __m128i& south, const __m128i& west, const __m128i& east) const
+	{
+		const __m128i lumaCenter{ LumaX4(center) };
+		const __m128i lumaNorth{ LumaX4(north) };
+		const __m128i lumaSouth{ LumaX4(south) };
+		const __m128i lumaWest{ LumaX4(west) };
+		const __m128i lumaEast{ LumaX4(east) };
+
+		// The lumas fit in the low 16 bits of every lane, the high halves are 0 on both sides
+		const __m128i lumaMaxI{ _mm_max_epi16(_mm_max_epi16(_mm_max_epi16(lumaNorth, lumaSouth), _mm_max_epi16(lumaWest, lumaEast)), lumaCenter) };
+		const __m128i lumaMinI{ _mm_min_epi16(_mm_min_epi16(_mm_min_epi16(lumaNorth, lumaSouth), _mm_min_epi16(lumaWest, lumaEast)), lumaCenter) };
+
+		const FloatX4 lumaMax{ _mm_cvtepi32_ps(lumaMaxI) };
+		const FloatX4 lumaRange{ lumaMax - FloatX4{ _mm_cvtepi32_ps(lumaMinI) } };
+
+		constexpr float maxLuma{ 2040.f };
+		const FloatX4 isEdge{ (lumaRange >= FloatX4::Max(lumaMax * m_EdgeThreshold, m_EdgeThresholdMin * maxLuma)) & (lumaRange > 0.f) };
+
+		// Flat areas are most of the frame, leave them alone
+		if (isEdge.MoveMask() == 0) return center;
+
+		const FloatX4 m{ _mm_cvtepi32_ps(lumaCenter) };
+		const FloatX4 n{ _mm_cvtepi32_ps(lumaNorth) };
+		const FloatX4 s{ _mm_cvtepi32_ps(lumaSouth) };
+		const FloatX4 w{ _mm_cvtepi32_ps(lumaWest) };
+		const FloatX4 e{ _mm_cvtepi32_ps(lumaEast) };
+
+		const auto abs = [](const FloatX4& a) { return FloatX4::Max(a, -a); };
+
+		// How much the pixel stands out from the average around it, relative to the local contrast
+		const FloatX4 average{ (n + s + w + e) * .25f };
+		const FloatX4 subpixel{ FloatX4::Clamp(abs(average - m) / FloatX4::Max(lumaRange, 1.f), 0.f, 1.f) };
+		const FloatX4 smooth{ subpixel * subpixel * (FloatX4{ 3.f } - subpixel * 2.f) };
+		const FloatX4 blendFactor{ smooth * smooth * m_SubpixelQuality };
+
+		// A horizontal edge changes most going up or down, so blend with the steeper of north & south, west & east otherwise
+		const FloatX4 isHorizontal{ abs(n + s - m * 2.f) >= abs(w + e - m * 2.f) };
+		const FloatX4 pickNorth{ abs(n - m) >= abs(s - m) };
+		const FloatX4 pickWest{ abs(w - m) >= abs(e - m) };
+
+		const auto select = [](const FloatX4& mask, const __m128i& a, const __m128i& b)
+		{
+			const __m128i maskI{ _mm_castps_si128(mask.v) };
+			return _mm_or_si128(_mm_and_si128(maskI, a), _mm_andnot_si128(maskI, b));
+		};
+		const __m128i target{ select(isHorizontal, select(pickNorth, north, south), select(pickWest, west, east)) };
+
+		// 0 outside edges so those lanes come out unchanged
+		const __m128i weights32{ _mm_cvttps_epi32(FloatX4::Mask(isEdge, blendFactor * static_cast<float>(1 << m_WeightBits)).v) };
+		const __m128i weights16{ _mm_unpacklo_epi16(_mm_packs_epi32(weights32, weights32), _mm_packs_epi32(weights32, weights32)) };
+		const __m128i weightsLow{ _mm_unpacklo_epi32(weights16, weights16) };
+		const __m128i weightsHigh{ _mm_unpackhi_epi32(weights16, weights16) };
+
+		// a + (b - a) * weight per channel, two pixels of four 16 bit channels at a time
+		const auto lerp = [](__m128i a, __m128i b, __m128i weight)
+		{
+			return _mm_add_epi16(a, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(b, a), weight), m_WeightBits));
+		};
+
+		const __m128i zero{ _mm_setzero_si128() };
+		const __m128i low{ lerp(_mm_unpacklo_epi8(center, zero), _mm_unpacklo_epi8(target, zero), weightsLow) };
+		const __m128i high{ lerp(_mm_unpackhi_epi8(center, zero), _mm_unpackhi_epi8(target, zero), weightsHigh) };
+		return _mm_packus_epi16(low, high);
+	}
+
+	__m128i FxaaPass::LumaX4(const __m128i& pixels) const
+	{
+		const __m128i byteMask{ _mm_set1_epi32(0xFF) };
+		const __m128i red{ _mm_and_si128(_mm_srl_epi32(pixels, m_RedShift), byteMask) };
+		const __m128i green{ _mm_and_si128(_mm_srl_epi32(pixels, m_GreenShift), byteMask) };
+		const __m128i blue{ _mm_and_si128(_mm_srl_epi32(pixels, m_BlueShift), byteMask) };
+
+		// 2R + 5G + B with shifts & adds, SSE2 has no 32 bit multiply
+		const __m128i greenX5{ _mm_add_epi32(_mm_slli_epi32(green, 2), green) };
+		return _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(red, red), greenX5), blue);
+	}
+}
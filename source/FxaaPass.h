@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+
+#include "SimdMath.h"
+
+struct SDL_PixelFormat;
+
+namespace dae
+{
+	class WorkerPool;
+
+	// FXAA style anti-aliasing over a finished 32 bit frame: finds edges from the luma contrast around every pixel
+	// and blends across them by how much the pixel stands out from its neighbours (FXAA's subpixel part, no edge end search)
+	class FxaaPass final
+	{
+	public:
+		FxaaPass() = default;
+		~FxaaPass() = default;
+
+		FxaaPass(const FxaaPass& other) = delete;
+		FxaaPass operator=(const FxaaPass& other) = delete;
+		FxaaPass(FxaaPass&& other) = delete;
+		FxaaPass operator=(FxaaPass&& other) = delete;
+
+		// In place, the pitch has to be width pixels. Reads from a copy of the frame, bands of rows get spread over the pool
+		void Apply(uint32_t* pPixels, int width, int height, const SDL_PixelFormat* pFormat, WorkerPool* pWorkerPool);
+
+	private:
+		static constexpr int m_NrOfRowsPerJob{ 16 };
+		static constexpr int m_WeightBits{ 7 };			// Blend weights, same 16 bit lane trick as the upscaler
+		static constexpr float m_EdgeThreshold{ .125f };	// Contrast needed, relative to the brightest pixel around
+		static constexpr float m_EdgeThresholdMin{ .0625f };	// and absolute, so dark areas don't count every bit of noise as an edge
+		static constexpr float m_SubpixelQuality{ .75f };	// Most a pixel moves toward its neighbour
+
+		std::vector<uint32_t> m_Source{};
+		__m128i m_RedShift{};
+		__m128i m_GreenShift{};
+		__m128i m_BlueShift{};
+
+		void ApplyRows(uint32_t* pPixels, int width, int height, int firstRow, int endRow) const;
+		// Four pixels side by side with their four neighbours, returns the blended pixels
+		__m128i BlendX4(const __m128i& center, const __m128i& north, const __m128i& south, const __m128i& west, const __m128i& east) const;
+		// 2R + 5G + B, 0 to 2040
+		__m128i LumaX4(const __m128i& pixels) const;
+	};
+}
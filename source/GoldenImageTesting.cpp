@@ -0,0 +1,273 @@
+#include "pch.h"
+#include "GoldenImageTesting.h"
+
+#include <filesystem>
+#include <iomanip>
+#include <thread>
+
+#include "Renderer.h"
+#include "ConsoleColorCtrl.h"
+
+namespace dae
+{
+	// Straight on, close up from above & the flank, vehicle sits at z = 50
+	const std::vector<GoldenImageTesting::CameraPose> GoldenImageTesting::m_CameraPoses
+	{
+		{ { 0.f, 0.f, 0.f },		0.f,	0.f },
+		{ { 0.f, 5.f, 25.f },		.1f,	0.f },
+		{ { -25.f, 0.f, 25.f },		0.f,	.785f }
+	};
+
+	GoldenImageTesting::GoldenImageTesting(const Settings& settings) :
+		m_Settings{ settings },
+		m_pRenderer{ new Renderer{ settings.width, settings.height } }
+	{
+		// References are always the scalar path on one worker, every worker count gets compared against them
+		if (m_Settings.isRecording)
+		{
+			m_Settings.useSimdShading = false;
+			m_WorkerCounts.push_back(1);
+		}
+		else
+		{
+			const int nrOfHardwareThreads{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) };
+			for (int nrOfWorkers{ 1 }; nrOfWorkers < nrOfHardwareThreads; nrOfWorkers *= 2) m_WorkerCounts.push_back(nrOfWorkers);
+			m_WorkerCounts.push_back(nrOfHardwareThreads);
+		}
+
+		m_pRenderer->SetSimdShading(m_Settings.useSimdShading);
+	}
+
+	GoldenImageTesting::~GoldenImageTesting()
+	{
+		SAFE_DELETE(m_pRenderer)
+	}
+
+	int GoldenImageTesting::Run()
+	{
+		if (m_Settings.isRecording) std::filesystem::create_directories(m_Settings.referenceDirectory);
+		else
+		{
+			// Comparing against nothing would only print a wall of failures, say what to do instead
+			const int nrOfMissingReferences{ CountMissingReferences() };
+			if (nrOfMissingReferences > 0)
+			{
+				ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+				std::cout << "**(SOFTWARE) Golden images, " << nrOfMissingReferences << " reference(s) missing from " << m_Settings.referenceDirectory << '\n'
+					<< "	Record them once on a known good build with --golden record (scalar path, 1 worker) and commit them" << std::endl;
+				return nrOfMissingReferences;
+			}
+		}
+
+		int nrOfFailedCases{};
+		int nrOfCases{};
+
+		for (int nrOfWorkers : m_WorkerCounts)
+		{
+			m_pRenderer->SetWorkerCount(nrOfWorkers);
+
+			for (size_t poseIdx{}; poseIdx < m_CameraPoses.size(); ++poseIdx)
+			{
+				for (int shadingIdx{}; shadingIdx < static_cast<int>(ShadingMode::ENUM_END); ++shadingIdx)
+				{
+					for (int cullingIdx{}; cullingIdx < static_cast<int>(CullingMode::ENUM_END); ++cullingIdx)
+					{
+						const ShadingMode shadingMode{ static_cast<ShadingMode>(shadingIdx) };
+						const CullingMode cullingMode{ static_cast<CullingMode>(cullingIdx) };
+
+						++nrOfCases;
+						if (!RunCase(GetCaseName(poseIdx, shadingMode, cullingMode), m_CameraPoses[poseIdx], shadingMode, cullingMode)) ++nrOfFailedCases;
+					}
+				}
+			}
+		}
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Golden images, " << (m_Settings.isRecording ? "recorded " : "passed ") << nrOfCases - nrOfFailedCases
+			<< '/' << nrOfCases << (m_Settings.useSimdShading ? " (SIMD QUADS)" : " (SCALAR)") << std::endl;
+
+		return nrOfFailedCases;
+	}
+
+	bool GoldenImageTesting::RunCase(const std::string& caseName, const CameraPose& pose, ShadingMode shadingMode, CullingMode cullingMode)
+	{
+		const std::string referencePath{ m_Settings.referenceDirectory + caseName + ".bmp" };
+		const std::string workersName{ " (" + std::to_string(m_pRenderer->GetWorkerCount()) + " workers)" };
+
+		SDL_Surface* pFrame{ RenderCase(pose, shadingMode, cullingMode) };
+		if (!pFrame)
+		{
+			std::cout << "	FAIL	" << caseName << workersName << ": could not convert the frame, " << SDL_GetError() << '\n';
+			return false;
+		}
+
+		if (m_Settings.isRecording)
+		{
+			const bool isSaved{ SDL_SaveBMP(pFrame, referencePath.c_str()) == 0 };
+			if (!isSaved) std::cout << "	FAIL	" << caseName << ": could not write " << referencePath << '\n';
+			SDL_FreeSurface(pFrame);
+			return isSaved;
+		}
+
+		SDL_Surface* pLoadedReference{ SDL_LoadBMP(referencePath.c_str()) };
+		if (!pLoadedReference)
+		{
+			std::cout << "	FAIL	" << caseName << workersName << ": no reference at " << referencePath << '\n';
+			SDL_FreeSurface(pFrame);
+			return false;
+		}
+
+		SDL_Surface* pReference{ SDL_ConvertSurfaceFormat(pLoadedReference, SDL_PIXELFORMAT_ARGB8888, 0) };
+		SDL_FreeSurface(pLoadedReference);
+
+		if (!pReference)
+		{
+			std::cout << "	FAIL	" << caseName << workersName << ": could not convert " << referencePath << ", " << SDL_GetError() << '\n';
+			SDL_FreeSurface(pFrame);
+			return false;
+		}
+
+		if (pReference->w != pFrame->w || pReference->h != pFrame->h)
+		{
+			std::cout << "	FAIL	" << caseName << workersName << ": reference is " << pReference->w << 'x' << pReference->h << '\n';
+			SDL_FreeSurface(pReference);
+			SDL_FreeSurface(pFrame);
+			return false;
+		}
+
+		SDL_Surface* pDiff{ SDL_CreateRGBSurfaceWithFormat(0, pFrame->w, pFrame->h, 32, SDL_PIXELFORMAT_ARGB8888) };
+		const Comparison comparison{ Compare(pFrame, pReference, pDiff) };
+
+		const float mismatchRatio{ static_cast<float>(comparison.nrOfMismatches) / static_cast<float>(pFrame->w * pFrame->h) };
+		const bool hasPassed{ mismatchRatio <= m_Settings.maxMismatchRatio && comparison.psnr >= m_Settings.minPsnr };
+
+		std::cout << (hasPassed ? "	PASS	" : "	FAIL	") << caseName << workersName << std::fixed << std::setprecision(2)
+			<< "	PSNR: " << comparison.psnr << " dB	Mismatches: " << comparison.nrOfMismatches << std::defaultfloat << '\n';
+
+		// One diff per worker count, a mismatch on more workers only is a race between tiles
+		if (!hasPassed && pDiff)
+		{
+			const std::string diffPath{ m_Settings.referenceDirectory + caseName + "_w" + std::to_string(m_pRenderer->GetWorkerCount()) + "_diff.bmp" };
+			SDL_SaveBMP(pDiff, diffPath.c_str());
+		}
+
+		SDL_FreeSurface(pDiff);
+		SDL_FreeSurface(pReference);
+		SDL_FreeSurface(pFrame);
+		return hasPassed;
+	}
+
+	int GoldenImageTesting::CountMissingReferences() const
+	{
+		int nrOfMissingReferences{};
+
+		for (size_t poseIdx{}; poseIdx < m_CameraPoses.size(); ++poseIdx)
+		{
+			for (int shadingIdx{}; shadingIdx < static_cast<int>(ShadingMode::ENUM_END); ++shadingIdx)
+			{
+				for (int cullingIdx{}; cullingIdx < static_cast<int>(CullingMode::ENUM_END); ++cullingIdx)
+				{
+					const std::string caseName{ GetCaseName(poseIdx, static_cast<ShadingMode>(shadingIdx), static_cast<CullingMode>(cullingIdx)) };
+					if (!std::filesystem::exists(m_Settings.referenceDirectory + caseName + ".bmp")) ++nrOfMissingReferences;
+				}
+			}
+		}
+
+		return nrOfMissingReferences;
+	}
+
+	SDL_Surface* GoldenImageTesting::RenderCase(const CameraPose& pose, ShadingMode shadingMode, CullingMode cullingMode)
+	{
+		m_pRenderer->SetShadingMode(shadingMode);
+		m_pRenderer->SetCullingMode(cullingMode);
+		m_pRenderer->SetCameraPose(pose.origin, pose.pitch, pose.yaw);
+
+		// No time passes, so the mesh stays at its initial rotation
+		m_pRenderer->Update(0.f);
+		m_pRenderer->Render();
+
+		// Copy into one fixed format, so references don't depend on the layout the renderer picked
+		SDL_Surface* pFrameView{ SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(m_pRenderer->GetFramePixels()), m_Settings.width, m_Settings.height,
+			32, m_pRenderer->GetFramePitch(), m_pRenderer->GetFrameFormat()->format) };
+		if (!pFrameView) return nullptr;
+
+		SDL_Surface* pFrame{ SDL_ConvertSurfaceFormat(pFrameView, SDL_PIXELFORMAT_ARGB8888, 0) };
+		SDL_FreeSurface(pFrameView);
+
+		return pFrame;
+	}
+
+	GoldenImageTesting::Comparison GoldenImageTesting::Compare(const SDL_Surface* pFrame, const SDL_Surface* pReference, SDL_Surface* pDiff) const
+	{
+		Comparison comparison{};
+		uint64_t squaredErrorSum{};
+
+		for (int py{}; py < pFrame->h; ++py)
+		{
+			const uint32_t* pFrameRow{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pFrame->pixels) + py * pFrame->pitch) };
+			const uint32_t* pReferenceRow{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pReference->pixels) + py * pReference->pitch) };
+			uint32_t* pDiffRow{ reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pDiff->pixels) + py * pDiff->pitch) };
+
+			for (int px{}; px < pFrame->w; ++px)
+			{
+				int maxChannelError{};
+				for (int shift{}; shift < 24; shift += 8)
+				{
+					const int channelError{ std::abs(static_cast<int>((pFrameRow[px] >> shift) & 0xFF) - static_cast<int>((pReferenceRow[px] >> shift) & 0xFF)) };
+					squaredErrorSum += static_cast<uint64_t>(channelError * channelError);
+					maxChannelError = std::max(maxChannelError, channelError);
+				}
+
+				// Red where the tolerance is broken, amplified grey error everywhere else
+				if (maxChannelError > m_Settings.channelTolerance)
+				{
+					++comparison.nrOfMismatches;
+					pDiffRow[px] = 0xFFFF0000;
+				}
+				else
+				{
+					const uint32_t grey{ static_cast<uint32_t>(std::min(maxChannelError * 32, 255)) };
+					pDiffRow[px] = 0xFF000000 | (grey << 16) | (grey << 8) | grey;
+				}
+			}
+		}
+
+		// Identical images get a capped PSNR instead of infinity
+		const double meanSquaredError{ static_cast<double>(squaredErrorSum) / (3.0 * pFrame->w * pFrame->h) };
+		comparison.psnr = meanSquaredError > 0.0 ? static_cast<float>(10.0 * log10(255.0 * 255.0 / meanSquaredError)) : 99.f;
+
+		return comparison;
+	}
+
+	std::string GoldenImageTesting::GetCaseName(size_t poseIdx, ShadingMode shadingMode, CullingMode cullingMode)
+	{
+		return "pose" + std::to_string(poseIdx) + '_' + GetShadingModeName(shadingMode) + '_' + GetCullingModeName(cullingMode);
+	}
+
+	const char* GoldenImageTesting::GetShadingModeName(ShadingMode shadingMode)
+	{
+		switch (shadingMode)
+		{
+		case ShadingMode::observedArea:	return "OBSERVED_AREA";
+		case ShadingMode::diffuse:		return "DIFFUSE";
+		case ShadingMode::specular:		return "SPECULAR";
+		case ShadingMode::combined:		return "COMBINED";
+		case ShadingMode::ENUM_END:		break;
+		}
+
+		return "UNKNOWN";
+	}
+
+	const char* GoldenImageTesting::GetCullingModeName(CullingMode cullingMode)
+	{
+		switch (cullingMode)
+		{
+		case CullingMode::back:		return "BACK";
+		case CullingMode::front:	return "FRONT";
+		case CullingMode::none:		return "NONE";
+		case CullingMode::ENUM_END:	break;
+		}
+
+		return "UNKNOWN";
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Math.h"
+
+struct SDL_Surface;
+
+namespace dae
+{
+	class Renderer;
+	enum class ShadingMode;
+	enum class CullingMode;
+
+	// Renders fixed camera poses in every shading/culling combination and compares them against stored reference images,
+	// references get recorded once with the scalar path on one worker (--golden record) so optimized paths & every worker count can be checked against it
+	class GoldenImageTesting final
+	{
+	public:
+		struct Settings
+		{
+			int width{ 320 };
+			int height{ 240 };
+			std::string referenceDirectory{ "Resources/Golden/" };
+			bool isRecording{ false };		// Overwrite the references instead of comparing, always scalar on one worker
+			bool useSimdShading{ false };
+
+			int channelTolerance{ 2 };		// Per channel, out of 255
+			float maxMismatchRatio{ .001f };	// Pixels past the tolerance, relative to the whole image
+			float minPsnr{ 40.f };			// dB
+		};
+
+		explicit GoldenImageTesting(const Settings& settings);
+		~GoldenImageTesting();
+
+		GoldenImageTesting(const GoldenImageTesting& other) = delete;
+		GoldenImageTesting operator=(const GoldenImageTesting& other) = delete;
+		GoldenImageTesting(GoldenImageTesting&& other) = delete;
+		GoldenImageTesting operator=(GoldenImageTesting&& other) = delete;
+
+		// Returns the number of failed cases, recording never fails unless a file can't be written.
+		// Comparing without references fails every missing one up front
+		int Run();
+
+	private:
+		struct CameraPose
+		{
+			Vector3 origin;
+			float pitch;
+			float yaw;
+		};
+
+		struct Comparison
+		{
+			int nrOfMismatches{};
+			float psnr{};
+		};
+
+		static const std::vector<CameraPose> m_CameraPoses;
+
+		Settings m_Settings;
+		Renderer* m_pRenderer;
+		std::vector<int> m_WorkerCounts{};
+
+		bool RunCase(const std::string& caseName, const CameraPose& pose, ShadingMode shadingMode, CullingMode cullingMode);
+		int CountMissingReferences() const;
+		SDL_Surface* RenderCase(const CameraPose& pose, ShadingMode shadingMode, CullingMode cullingMode);
+		Comparison Compare(const SDL_Surface* pFrame, const SDL_Surface* pReference, SDL_Surface* pDiff) const;
+
+		static std::string GetCaseName(size_t poseIdx, ShadingMode shadingMode, CullingMode cullingMode);
+		static const char* GetShadingModeName(ShadingMode shadingMode);
+		static const char* GetCullingModeName(CullingMode cullingMode);
+	};
+}
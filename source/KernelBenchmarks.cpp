@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "KernelBenchmarks.h"
+
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "Utils.h"
+#include "ConsoleColorCtrl.h"
+
+namespace dae
+{
+	KernelBenchmarks::KernelBenchmarks(uint32_t seed, int nrOfInputs) :
+		m_NrOfInputs{ nrOfInputs },
+		m_pRenderer{ new Renderer{ 640, 480 } },
+		m_pTexture{ new Texture{ "Resources/vehicle_diffuse.png", nullptr } }
+	{
+		std::mt19937 generator{ seed };
+		std::uniform_real_distribution<float> unitDistribution{ -1.f, 1.f };
+		std::uniform_real_distribution<float> uvDistribution{ 0.f, 1.f };
+		std::uniform_real_distribution<float> angleDistribution{ -PI, PI };
+		std::uniform_real_distribution<float> pixelXDistribution{ 0.f, static_cast<float>(m_pRenderer->GetWidth() - 1) };
+		std::uniform_real_distribution<float> pixelYDistribution{ 0.f, static_cast<float>(m_pRenderer->GetHeight() - 1) };
+
+		// Every draw gets its own statement, function arguments are evaluated in an unspecified order
+		// so drawing inside an argument list would give other inputs per compiler
+		const auto randomVector = [&generator](std::uniform_real_distribution<float>& distribution)
+		{
+			const float x{ distribution(generator) };
+			const float y{ distribution(generator) };
+			const float z{ distribution(generator) };
+			return Vector3{ x, y, z };
+		};
+		const auto randomPixel = [&]()
+		{
+			const float x{ pixelXDistribution(generator) };
+			const float y{ pixelYDistribution(generator) };
+			return Vector2{ x, y };
+		};
+		const auto randomUnitVector = [&]() { return randomVector(unitDistribution).Normalized(); };
+
+		m_Matrices.reserve(nrOfInputs);
+		m_Points.reserve(nrOfInputs);
+		m_PixelPositions.reserve(nrOfInputs);
+		m_Uvs.reserve(nrOfInputs);
+		m_Vertices.reserve(nrOfInputs);
+		m_Areas.reserve(nrOfInputs);
+
+		for (int inputIdx{}; inputIdx < nrOfInputs; ++inputIdx)
+		{
+			// Rotation + translation, like the world matrices, always invertible
+			const Vector3 rotation{ randomVector(angleDistribution) };
+			const Vector3 translation{ randomVector(unitDistribution) * 50.f };
+			m_Matrices.push_back(Matrix::CreateRotation(rotation) * Matrix::CreateTranslation(translation));
+			m_Points.push_back(randomVector(unitDistribution) * 50.f);
+			m_PixelPositions.push_back(randomPixel());
+
+			const float u{ uvDistribution(generator) };
+			const float v{ uvDistribution(generator) };
+			m_Uvs.emplace_back(u, v);
+
+			// Screen space position, the rest is what a rasterized fragment carries
+			const Vector2 pixel{ randomPixel() };
+			const float depth{ uvDistribution(generator) };
+			const float viewDepth{ 1.f + uvDistribution(generator) * 50.f };
+			Vertex_Out vertex{};
+			vertex.position = { pixel.x, pixel.y, depth, viewDepth };
+			vertex.uv = m_Uvs.back();
+			vertex.normal = randomUnitVector();
+			vertex.tangent = Vector3::Cross(vertex.normal, Vector3::UnitY).Normalized();
+			vertex.viewDirection = randomUnitVector();
+			vertex.tangentLightDirection = randomUnitVector();
+			vertex.tangentViewDirection = randomUnitVector();
+			vertex.worldPosition = m_Points.back();
+			m_Vertices.push_back(vertex);
+
+			m_Areas.push_back(100.f + uvDistribution(generator) * 10000.f);
+		}
+
+		// Culls the lights once, the shading reads the per tile light lists
+		m_pRenderer->Update(0.f);
+	}
+
+	KernelBenchmarks::~KernelBenchmarks()
+	{
+		SAFE_DELETE(m_pTexture)
+		SAFE_DELETE(m_pRenderer)
+	}
+
+	template<typename T_Kernel>
+	void KernelBenchmarks::Measure(const std::string& name, const T_Kernel& kernel)
+	{
+		const double nsPerTick{ 1.0e9 / static_cast<double>(SDL_GetPerformanceFrequency()) };
+		const double nrOfOpsPerSample{ static_cast<double>(m_NrOfPassesPerSample) * m_NrOfInputs };
+
+		// One untimed pass to warm the caches
+		float sink{};
+		for (int inputIdx{}; inputIdx < m_NrOfInputs; ++inputIdx) sink += kernel(inputIdx);
+
+		double bestNsPerOp{ DBL_MAX };
+		for (int sampleIdx{}; sampleIdx < m_NrOfSamples; ++sampleIdx)
+		{
+			const uint64_t startTicks{ SDL_GetPerformanceCounter() };
+			for (int passIdx{}; passIdx < m_NrOfPassesPerSample; ++passIdx)
+			{
+				for (int inputIdx{}; inputIdx < m_NrOfInputs; ++inputIdx) sink += kernel(inputIdx);
+			}
+			const double nsPerOp{ static_cast<double>(SDL_GetPerformanceCounter() - startTicks) * nsPerTick / nrOfOpsPerSample };
+			bestNsPerOp = std::min(bestNsPerOp, nsPerOp);
+		}
+
+		m_Sink = m_Sink + sink;
+		m_Results.push_back({ name, bestNsPerOp, 1.0e9 / bestNsPerOp });
+	}
+
+	void KernelBenchmarks::Run()
+	{
+		m_Results.clear();
+
+		Measure("Matrix::TransformPoint", [&](int idx)
+		{
+			return m_Matrices[idx].TransformPoint(m_Points[idx]).x;
+		});
+
+		Measure("Matrix::Inverse", [&](int idx)
+		{
+			return Matrix::Inverse(m_Matrices[idx]).GetTranslation().x;
+		});
+
+		Measure("Vector3::Normalize", [&](int idx)
+		{
+			Vector3 point{ m_Points[idx] };
+			return point.Normalize() + point.x;
+		});
+
+		// Consecutive inputs form the triangle, like the three weights of one pixel
+		Measure("Utils::CalcWeight", [&](int idx)
+		{
+			const Vertex_Out& next{ m_Vertices[idx] };
+			const Vertex_Out& previous{ m_Vertices[(idx + 1) % m_NrOfInputs] };
+			return Utils::CalcWeight(next, previous, m_PixelPositions[idx], m_Areas[idx]);
+		});
+
+		Measure("Texture::Sample", [&](int idx)
+		{
+			return m_pTexture->Sample(m_Uvs[idx]).r;
+		});
+
+		Measure("Renderer::PixelShading", [&](int idx)
+		{
+			return m_pRenderer->PixelShading(m_Vertices[idx]).g;
+		});
+	}
+
+	void KernelBenchmarks::PrintResults() const
+	{
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Kernel Benchmarks, " << m_NrOfInputs << " inputs, best of " << m_NrOfSamples << " samples\n"
+			<< std::fixed << std::setprecision(2)
+			<< "	" << std::left << std::setw(26) << "KERNEL" << std::right << std::setw(12) << "NS/OP" << std::setw(14) << "MOPS/S" << '\n';
+
+		for (const Result& result : m_Results)
+		{
+			std::cout << "	" << std::left << std::setw(26) << result.name << std::right
+				<< std::setw(12) << result.nsPerOp << std::setw(14) << result.opsPerSecond / 1.0e6 << '\n';
+		}
+		std::cout << std::defaultfloat << std::flush;
+	}
+
+	bool KernelBenchmarks::WriteJson(const std::string& filePath) const
+	{
+		if (m_Results.empty()) return false;
+
+		std::ofstream file{ filePath };
+		if (!file) return false;
+
+		file << std::fixed << std::setprecision(4) << "{\n\t\"inputs\": " << m_NrOfInputs << ",\n\t\"kernels\": [\n";
+		for (size_t resultIdx{}; resultIdx < m_Results.size(); ++resultIdx)
+		{
+			const Result& result{ m_Results[resultIdx] };
+			file << "\t\t{ \"name\": \"" << result.name << "\", \"nsPerOp\": " << result.nsPerOp << ", \"opsPerSecond\": " << result.opsPerSecond << " }"
+				<< (resultIdx + 1 < m_Results.size() ? ",\n" : "\n");
+		}
+		file << "\t]\n}\n";
+
+		return true;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Structs.h"
+
+namespace dae
+{
+	class Renderer;
+	class Texture;
+
+	// Hot math, sampling & shading functions timed in isolation, on seeded random inputs so every run sees the same data
+	class KernelBenchmarks final
+	{
+	public:
+		explicit KernelBenchmarks(uint32_t seed = 1337, int nrOfInputs = 4096);
+		~KernelBenchmarks();
+
+		KernelBenchmarks(const KernelBenchmarks& other) = delete;
+		KernelBenchmarks operator=(const KernelBenchmarks& other) = delete;
+		KernelBenchmarks(KernelBenchmarks&& other) = delete;
+		KernelBenchmarks operator=(KernelBenchmarks&& other) = delete;
+
+		void Run();
+		void PrintResults() const;
+		bool WriteJson(const std::string& filePath) const;
+
+	private:
+		static constexpr int m_NrOfSamples{ 7 };		// Best one is kept, the others mostly measure noise
+		static constexpr int m_NrOfPassesPerSample{ 64 };	// Passes over all inputs per timed sample
+
+		struct Result
+		{
+			std::string name;
+			double nsPerOp;
+			double opsPerSecond;
+		};
+
+		int m_NrOfInputs;
+
+		std::vector<Matrix> m_Matrices{};
+		std::vector<Vector3> m_Points{};
+		std::vector<Vector2> m_PixelPositions{};
+		std::vector<Vector2> m_Uvs{};
+		std::vector<Vertex_Out> m_Vertices{};		// Triangles for the weights, fragments for the shading
+		std::vector<float> m_Areas{};
+
+		Renderer* m_pRenderer;
+		Texture* m_pTexture;
+
+		std::vector<Result> m_Results{};
+
+		// Sink for every kernel's output, so the compiler can't throw the work away
+		volatile float m_Sink{};
+
+		// Kernel takes an input index & returns something derived from its output
+		template<typename T_Kernel>
+		void Measure(const std::string& name, const T_Kernel& kernel);
+	};
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "ColorRGB.h"
+#include "Vector3.h"
+#include "SimdMath.h"
+
+namespace dae
+{
+	enum class LightType
+	{
+		directional,
+		point,
+		spot
+	};
+
+	struct Light
+	{
+		LightType type{ LightType::directional };
+
+		Vector3 origin{};		// Point & spot
+		Vector3 direction{};	// Directional & spot, the direction the light travels in
+		ColorRGB color{ 1.f, 1.f, 1.f };
+		float intensity{};
+
+		float range{};			// Point & spot, no light reaches beyond this distance
+		float cosInnerCone{};	// Spot, full intensity inside
+		float cosOuterCone{};	// Spot, no light outside
+
+		// Falloff of point & spot lights for a fragment at distance along toFragment (normalized), 1 for directional lights
+		float CalculateAttenuation(const Vector3& toFragment, float distance) const
+		{
+			if (type == LightType::directional) return 1.f;
+			if (distance >= range) return 0.f;
+
+			// Windowed falloff, reaches exactly 0 at the range so culling by range is lossless
+			const float window{ 1.f - Square(distance / range) };
+			float attenuation{ window * window };
+
+			if (type == LightType::spot)
+			{
+				const float cosAngle{ Vector3::Dot(toFragment, direction) };
+				const float cone{ Saturate((cosAngle - cosOuterCone) / (cosInnerCone - cosOuterCone)) };
+				attenuation *= cone * cone * (3.f - 2.f * cone); // Smoothstep
+			}
+			return attenuation;
+		}
+
+		// CalculateAttenuation for the four fragments of a quad
+		FloatX4 CalculateAttenuationX4(const Vector3X4& toFragment, const FloatX4& distance) const
+		{
+			if (type == LightType::directional) return 1.f;
+
+			const FloatX4 relativeDistance{ distance * (1.f / range) };
+			const FloatX4 window{ FloatX4{ 1.f } - relativeDistance * relativeDistance };
+			FloatX4 attenuation{ FloatX4::Mask(distance < range, window * window) };
+
+			if (type == LightType::spot)
+			{
+				const FloatX4 cosAngle{ Vector3X4::Dot(toFragment, direction) };
+				const FloatX4 cone{ FloatX4::Clamp((cosAngle - cosOuterCone) * (1.f / (cosInnerCone - cosOuterCone)), 0.f, 1.f) };
+				attenuation *= cone * cone * (FloatX4{ 3.f } - cone * 2.f); // Smoothstep
+			}
+			return attenuation;
+		}
+	};
+}
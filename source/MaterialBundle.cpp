@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "MaterialBundle.h"
+#include <cassert>
+
+#include "Texture.h"
+
+namespace dae
+{
+	MaterialBundle::MaterialBundle(const Texture* pDiffuse, const Texture* pNormal, const Texture* pSpecular, const Texture* pGloss)
+		: m_Width{ pDiffuse->GetWidth() }
+		, m_Height{ pDiffuse->GetHeight() }
+	{
+		// All maps are sampled with the same uv, so they have to share the diffuse map's resolution
+		assert(pNormal->GetWidth() == m_Width && pNormal->GetHeight() == m_Height);
+		assert(pSpecular->GetWidth() == m_Width && pSpecular->GetHeight() == m_Height);
+		assert(pGloss->GetWidth() == m_Width && pGloss->GetHeight() == m_Height);
+
+		m_Texels.resize(static_cast<size_t>(m_Width) * m_Height);
+
+		// The maps come from 8 bit surfaces, so rounding back to bytes is lossless
+		const auto packColor = [](const ColorRGB& color, float alpha)
+		{
+			const auto toByte = [](float channel) { return static_cast<uint32_t>(Clamp(channel, 0.f, 1.f) * 255.f + .5f); };
+			return toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | (toByte(alpha) << 24);
+		};
+		const auto packNormal = [](const ColorRGB& color)
+		{
+			// [0, 1] to [-1, 1], then to signed bytes. -128 never comes out, so every byte decodes with the same scale
+			const auto toSignedByte = [](float channel) { return static_cast<uint32_t>(static_cast<uint8_t>(static_cast<int8_t>(std::lround(Clamp(2.f * channel - 1.f, -1.f, 1.f) * 127.f)))); };
+			return toSignedByte(color.r) | (toSignedByte(color.g) << 8) | (toSignedByte(color.b) << 16);
+		};
+
+		for (int py{}; py < m_Height; ++py)
+		{
+			for (int px{}; px < m_Width; ++px)
+			{
+				PackedMaterialTexel& texel{ m_Texels[px + py * m_Width] };
+				texel.diffuseGloss = packColor(pDiffuse->GetTexel(px, py), pGloss->GetTexel(px, py).r);
+				texel.normal = packNormal(pNormal->GetTexel(px, py));
+				texel.specular = packColor(pSpecular->GetTexel(px, py), 0.f);
+			}
+		}
+	}
+
+	MaterialTexel MaterialBundle::Sample(const Vector2& uv) const
+	{
+		// Same addressing as Texture::Sample, but clamped to the last texel so uv == 1 stays inside the bundle
+		const float uvX{ Clamp(uv.x, 0.f, 1.f) };
+		const float uvY{ Clamp(uv.y, 0.f, 1.f) };
+		const int px{ std::min(static_cast<int>(uvX * m_Width), m_Width - 1) };
+		const int py{ std::min(static_cast<int>(uvY * m_Height), m_Height - 1) };
+
+		const PackedMaterialTexel& packedTexel{ m_Texels[px + py * m_Width] };
+		const auto channel = [](uint32_t word, int channelIdx) { return static_cast<float>((word >> (channelIdx * 8)) & 0xFF) / 255.f; };
+		const auto signedChannel = [](uint32_t word, int channelIdx) { return static_cast<float>(static_cast<int8_t>((word >> (channelIdx * 8)) & 0xFF)) / 127.f; };
+
+		MaterialTexel texel{};
+		texel.diffuse = { channel(packedTexel.diffuseGloss, 0), channel(packedTexel.diffuseGloss, 1), channel(packedTexel.diffuseGloss, 2) };
+		texel.gloss = channel(packedTexel.diffuseGloss, 3);
+		texel.normal = { signedChannel(packedTexel.normal, 0), signedChannel(packedTexel.normal, 1), signedChannel(packedTexel.normal, 2) };
+		texel.specular = { channel(packedTexel.specular, 0), channel(packedTexel.specular, 1), channel(packedTexel.specular, 2) };
+		return texel;
+	}
+
+	MaterialTexelX4 MaterialBundle::SampleX4(const FloatX4& u, const FloatX4& v, int mask) const
+	{
+		// Addresses for all four lanes at once, texel indices stay well below 2^24 so float math is exact
+		const FloatX4 px{ FloatX4::Min(FloatX4{ _mm_cvtepi32_ps(_mm_cvttps_epi32((FloatX4::Clamp(u, 0.f, 1.f) * static_cast<float>(m_Width)).v)) }, static_cast<float>(m_Width - 1)) };
+		const FloatX4 py{ FloatX4::Min(FloatX4{ _mm_cvtepi32_ps(_mm_cvttps_epi32((FloatX4::Clamp(v, 0.f, 1.f) * static_cast<float>(m_Height)).v)) }, static_cast<float>(m_Height - 1)) };
+		const FloatX4 index{ px + py * static_cast<float>(m_Width) };
+
+		alignas(16) int indices[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(index.v));
+
+		// SSE2 has no gather, fetch the records one by one. Lanes outside the mask may hold garbage uvs, they read texel 0
+		const PackedMaterialTexel* pTexels[4]{};
+		for (int lane{}; lane < 4; ++lane) pTexels[lane] = &m_Texels[(mask & (1 << lane)) ? indices[lane] : 0];
+
+		const auto gather = [&pTexels](uint32_t PackedMaterialTexel::* pWord)
+		{
+			return _mm_setr_epi32(static_cast<int>(pTexels[0]->*pWord), static_cast<int>(pTexels[1]->*pWord),
+				static_cast<int>(pTexels[2]->*pWord), static_cast<int>(pTexels[3]->*pWord));
+		};
+		const __m128i diffuseGloss{ gather(&PackedMaterialTexel::diffuseGloss) };
+		const __m128i normal{ gather(&PackedMaterialTexel::normal) };
+		const __m128i specular{ gather(&PackedMaterialTexel::specular) };
+
+		// Byte of every lane to [0, 1]
+		const __m128i byteMask{ _mm_set1_epi32(0xFF) };
+		const FloatX4 toUnorm{ 1.f / 255.f };
+		const auto channel = [&](const __m128i& words, int channelIdx)
+		{
+			return FloatX4{ _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(words, _mm_cvtsi32_si128(channelIdx * 8)), byteMask)) } * toUnorm;
+		};
+
+		// Signed byte of every lane to [-1, 1], moved to the top byte so the arithmetic shift back sign extends it
+		const FloatX4 toSnorm{ 1.f / 127.f };
+		const auto signedChannel = [&](const __m128i& words, int channelIdx)
+		{
+			return FloatX4{ _mm_cvtepi32_ps(_mm_srai_epi32(_mm_sll_epi32(words, _mm_cvtsi32_si128(24 - channelIdx * 8)), 24)) } * toSnorm;
+		};
+
+		MaterialTexelX4 texels{};
+		texels.diffuse = { channel(diffuseGloss, 0), channel(diffuseGloss, 1), channel(diffuseGloss, 2) };
+		texels.gloss = channel(diffuseGloss, 3);
+		texels.normal = { signedChannel(normal, 0), signedChannel(normal, 1), signedChannel(normal, 2) };
+		texels.specular = { channel(specular, 0), channel(specular, 1), channel(specular, 2) };
+		return texels;
+	}
+
+	int MaterialBundle::GetWidth() const
+	{
+		return m_Width;
+	}
+
+	int MaterialBundle::GetHeight() const
+	{
+		return m_Height;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "SimdMath.h"
+
+namespace dae
+{
+	class Texture;
+
+	// All shading inputs of one texel, decoded. Sample builds it from the packed texel
+	struct MaterialTexel
+	{
+		ColorRGB diffuse{};
+		float gloss{};
+		Vector3 normal{};	// Tangent space, [-1, 1]
+		ColorRGB specular{};
+	};
+
+	// What the bundle stores: 8 bit channels, the same precision as the source maps, 12 bytes per texel
+	// Red in the low byte, the fourth byte of the normal & specular words is unused.
+	// Colors are unorm, the normal is snorm: remapped to [-1, 1] once when the bundle is built, so fetches only scale it
+	struct PackedMaterialTexel
+	{
+		uint32_t diffuseGloss{};
+		uint32_t normal{};
+		uint32_t specular{};
+	};
+
+	// Four texels transposed, one lane per fragment of a quad
+	struct MaterialTexelX4
+	{
+		ColorRGBX4 diffuse{};
+		FloatX4 gloss{};
+		Vector3X4 normal{};
+		ColorRGBX4 specular{};
+	};
+
+	class MaterialBundle
+	{
+	public:
+		// Software Rasterizer
+		MaterialBundle(const Texture* pDiffuse, const Texture* pNormal, const Texture* pSpecular, const Texture* pGloss);
+		~MaterialBundle() = default;
+
+		MaterialBundle(const MaterialBundle& other) = delete;
+		MaterialBundle operator=(const MaterialBundle& other) = delete;
+		MaterialBundle(MaterialBundle&& other) = delete;
+		MaterialBundle operator=(MaterialBundle&& other) = delete;
+
+		MaterialTexel Sample(const Vector2& uv) const;
+		MaterialTexelX4 SampleX4(const FloatX4& u, const FloatX4& v, int mask) const;
+
+		int GetWidth() const;
+		int GetHeight() const;
+
+	private:
+		int m_Width{};
+		int m_Height{};
+
+		std::vector<PackedMaterialTexel> m_Texels{};
+	};
+}
@@ -20,6 +20,8 @@ namespace dae {
 	public:
 		// Dual Rasterizer
 		explicit Mesh(ID3D11Device* pDevice, const std::string& objFilePath, EffectType fxType);
+		// Generated geometry, triangle list
+		explicit Mesh(ID3D11Device* pDevice, std::vector<T_Vertex> vertices, std::vector<uint32_t> indices, EffectType fxType);
 		~Mesh();
 
 		Mesh(const Mesh& other) = delete;
@@ -31,13 +33,15 @@ namespace dae {
 		const Matrix& GetWorldMatrix() const;
 		void UpdateRotation(float deltaTime);
 
+#ifndef DISABLE_DIRECTX
 		// Hardware Rasterizer
 		void HardwareRender(ID3D11DeviceContext* pDeviceContext, ID3D11Device* pDevice);
 		void UpdateEffectMatrices(Camera* pCamera);
 		Effect* GetEffect();
+#endif
 
 		// Software Rasterizer
-		void VerticesToProjectionSpace(const Matrix& viewMatrix, const Matrix& projectionMatrix, const Vector3& cameraPos);
+		void VerticesToProjectionSpace(const Matrix& viewMatrix, const Matrix& projectionMatrix, const Vector3& cameraPos, const Vector3& lightDirection);
 		std::vector<Vertex_Out>& GetVertexOutVector();
 		uint32_t GetNumIndices();
 		std::vector<uint32_t> GetIndices();
@@ -50,11 +54,14 @@ namespace dae {
 
 		// Hardware Rasterizer
 		uint32_t m_NumIndices;
+#ifndef DISABLE_DIRECTX
 		Effect* m_pEffect;
 		ID3D11Buffer* m_pVertexBuffer;
 		ID3D11Buffer* m_pIndexBuffer;
 
 		void InitializeEffect(ID3D11Device* pDevice, EffectType fxType);
+		void InitializeBuffers(ID3D11Device* pDevice);
+#endif
 
 		// Software Rasterizer
 		PrimitiveTopology m_pPrimitiveTopology{ PrimitiveTopology::TriangleList };
@@ -72,18 +79,53 @@ namespace dae {
 	//--------------------------------------
 #pragma region DUAL_RASTERIZER
 	template<typename T_Vertex>
-	Mesh<T_Vertex>::Mesh(ID3D11Device* pDevice, const std::string& objFilePath, EffectType fxType)
+	Mesh<T_Vertex>::Mesh([[maybe_unused]] ID3D11Device* pDevice, const std::string& objFilePath, [[maybe_unused]] EffectType fxType)
 		: m_Vertices{}
 		, m_Indices{}
+#ifndef DISABLE_DIRECTX
 		, m_pIndexBuffer(nullptr)
 		, m_pVertexBuffer(nullptr)
 		, m_pEffect(nullptr)
+#endif
 		, m_WorldMatrix()
 	{
 		Utils::ParseOBJ(objFilePath, m_Vertices, m_Indices);
+		m_NumIndices = static_cast<uint32_t>(m_Indices.size());
+
+		// Headless, no effect or GPU buffers. The software rasterizer only needs the vertices & indices
+#ifndef DISABLE_DIRECTX
+		if (pDevice == nullptr) return;
+
+		InitializeEffect(pDevice, fxType);
+		InitializeBuffers(pDevice);
+#endif
+	}
+
+	template<typename T_Vertex>
+	Mesh<T_Vertex>::Mesh([[maybe_unused]] ID3D11Device* pDevice, std::vector<T_Vertex> vertices, std::vector<uint32_t> indices, [[maybe_unused]] EffectType fxType)
+		: m_WorldMatrix()
+		, m_Vertices{ std::move(vertices) }
+		, m_Indices{ std::move(indices) }
+#ifndef DISABLE_DIRECTX
+		, m_pEffect(nullptr)
+		, m_pVertexBuffer(nullptr)
+		, m_pIndexBuffer(nullptr)
+#endif
+	{
+		m_NumIndices = static_cast<uint32_t>(m_Indices.size());
+
+#ifndef DISABLE_DIRECTX
+		if (pDevice == nullptr) return;
 
 		InitializeEffect(pDevice, fxType);
+		InitializeBuffers(pDevice);
+#endif
+	}
 
+#ifndef DISABLE_DIRECTX
+	template<typename T_Vertex>
+	void Mesh<T_Vertex>::InitializeBuffers(ID3D11Device* pDevice)
+	{
 		D3D11_BUFFER_DESC bd{};
 		bd.Usage = D3D11_USAGE_IMMUTABLE;
 		bd.ByteWidth = sizeof(T_Vertex) * static_cast<uint32_t>(m_Vertices.size());
@@ -100,7 +142,6 @@ namespace dae {
 			assert(false);
 		}
 
-		m_NumIndices = static_cast<uint32_t>(m_Indices.size());
 		bd.Usage = D3D11_USAGE_IMMUTABLE;
 		bd.ByteWidth = sizeof(uint32_t) * m_NumIndices;
 		bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
@@ -115,13 +156,16 @@ namespace dae {
 			return;
 		}
 	}
+#endif
 
 	template<typename T_Vertex>
 	Mesh<T_Vertex>::~Mesh()
 	{
+#ifndef DISABLE_DIRECTX
 		SAFE_DELETE(m_pEffect)
 		if(m_pVertexBuffer) m_pVertexBuffer->Release();
 		if(m_pIndexBuffer) m_pIndexBuffer->Release();
+#endif
 	}
 
 	template<typename T_Vertex>
@@ -147,6 +191,7 @@ namespace dae {
 	// HARDWARE RASTERIZER
 	//--------------------------------------
 #pragma region HARDWARE_RASTERIZER
+#ifndef DISABLE_DIRECTX
 
 	template<typename T_Vertex>
 	void Mesh<T_Vertex>::HardwareRender(ID3D11DeviceContext* pDeviceContext, ID3D11Device* pDevice)
@@ -191,6 +236,8 @@ namespace dae {
 	template<typename T_Vertex>
 	void Mesh<T_Vertex>::UpdateEffectMatrices(Camera* pCamera)
 	{
+		if (!m_pEffect) return; // Headless
+
 		m_pEffect->SetWorldMatrix(m_WorldMatrix);
 		m_pEffect->SetInvViewMatrix(pCamera->invViewMatrix);
 		m_pEffect->SetWorldViewProjMatrix(m_WorldMatrix * pCamera->viewMatrix * pCamera->projectionMatrix);
@@ -219,6 +266,7 @@ namespace dae {
 		}
 	}
 
+#endif
 #pragma endregion
 
 
@@ -227,7 +275,7 @@ namespace dae {
 	//--------------------------------------
 #pragma region SOFTWARE_RASTERIZER
 	template<typename T_Vertex>
-	void Mesh<T_Vertex>::VerticesToProjectionSpace(const Matrix& viewMatrix, const Matrix& projectionMatrix, const Vector3& cameraPos)
+	void Mesh<T_Vertex>::VerticesToProjectionSpace(const Matrix& viewMatrix, const Matrix& projectionMatrix, const Vector3& cameraPos, const Vector3& lightDirection)
 	{
 		const Matrix wvpMatrix{ m_WorldMatrix * viewMatrix * projectionMatrix };
 		m_Vertices_out.clear();
@@ -244,6 +292,9 @@ namespace dae {
 			outVertex.tangent = vertex.tangent;
 			outVertex.uv = vertex.uv;
 
+			// WORLD POSITION
+			outVertex.worldPosition = m_WorldMatrix.TransformPoint(vertex.position);
+
 			// VIEW DIRECTION
 			outVertex.viewDirection = wvpMatrix.TransformPoint(vertex.position) - cameraPos;
 
@@ -262,6 +313,12 @@ namespace dae {
 			outVertex.tangent = m_WorldMatrix.TransformVector(outVertex.tangent);
 			outVertex.tangent.Normalize();
 
+			// TANGENT SPACE
+			// Light & view direction projected on the tangent frame, so normal mapped shading can stay in tangent space
+			const Vector3 binormal{ Vector3::Cross(outVertex.normal, outVertex.tangent).Normalized() };
+			outVertex.tangentLightDirection = { Vector3::Dot(lightDirection, outVertex.tangent), Vector3::Dot(lightDirection, binormal), Vector3::Dot(lightDirection, outVertex.normal) };
+			outVertex.tangentViewDirection = { Vector3::Dot(outVertex.viewDirection, outVertex.tangent), Vector3::Dot(outVertex.viewDirection, binormal), Vector3::Dot(outVertex.viewDirection, outVertex.normal) };
+
 			m_Vertices_out.emplace_back(outVertex);
 		}
 	}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+namespace dae
+{
+	// Counters of the software path, every thread that rasterizes fills its own copy and they get merged at frame end
+	// Cache line aligned, so threads never share a line while counting
+	struct alignas(64) RasterizerStats
+	{
+		// Per triangle
+		uint64_t trianglesSubmitted{};
+		uint64_t frustumRejected{};
+		uint64_t zeroArea{};
+		uint64_t backfaceCulled{};	// Or frontface, whatever the culling mode throws away
+
+		// Per pixel
+		uint64_t pixelsTested{};	// Coverage tests, inside the bounding box
+		uint64_t pixelsCovered{};
+		uint64_t depthPasses{};
+		uint64_t shadedFragments{};
+		uint64_t textureSamples{};	// Material bundle fetches, the quad path always fetches all four lanes
+
+		// Profiling, shading is estimated from the sampled fragments, see SampledProfileScope
+		uint64_t shadingTicks{};
+		uint32_t shadingSampleCounter{};
+		uint64_t msaaResolveTicks{};
+		uint64_t clearTicks{};	// Tiles cleared on first touch, the untouched ones are resolved on the frame thread
+
+		RasterizerStats& operator+=(const RasterizerStats& other)
+		{
+			trianglesSubmitted += other.trianglesSubmitted;
+			frustumRejected += other.frustumRejected;
+			zeroArea += other.zeroArea;
+			backfaceCulled += other.backfaceCulled;
+			pixelsTested += other.pixelsTested;
+			pixelsCovered += other.pixelsCovered;
+			depthPasses += other.depthPasses;
+			shadedFragments += other.shadedFragments;
+			textureSamples += other.textureSamples;
+			shadingTicks += other.shadingTicks;
+			msaaResolveTicks += other.msaaResolveTicks;
+			clearTicks += other.clearTicks;
+
+			return *this;
+		}
+	};
+}
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Renderer.h"
+#include <random>
 #include "Mesh.h"
 #include "Structs.h"
 #include "Camera.h"
@@ -9,6 +10,19 @@
 #include "Effect_PosTex.h"
 #include "Effect_PosCol.h"	
 #include "Texture.h"
+#include "MaterialBundle.h"
+#include "SpecularEvaluator.h"
+#include "TiledLightCuller.h"
+#include "FramebufferWriter.h"
+#include "SoftwarePresenter.h"
+#include "DepthBuffer.h"
+#include "FrameProfiler.h"
+#include "TraceRecorder.h"
+#include "WorkerPool.h"
+#include "Upscaler.h"
+#include "DynamicResolution.h"
+#include "FxaaPass.h"
+#include <bit>
 #include "Utils.h"
 
 namespace dae
@@ -18,12 +32,17 @@ namespace dae
 	//--------------------------------------
 #pragma region DUAL_RASTERIZER
 	Renderer::Renderer(SDL_Window* pWindow) :
-		m_pWindow(pWindow)
+		m_pWindow(pWindow),
+		m_SpecularMode(SpecularMode::exact),
+		m_DepthFormat(DepthFormat::float32)
 	{
 		//Initialize
 		SDL_GetWindowSize(m_pWindow, &m_Width, &m_Height);
+		m_RenderWidth = m_Width;
+		m_RenderHeight = m_Height;
 
 		//Initialize DirectX pipeline
+#ifndef DISABLE_DIRECTX
 		const HRESULT result = InitializeDirectX();
 		if (result == S_OK)
 		{
@@ -34,9 +53,32 @@ namespace dae
 		{
 			std::cout << "DirectX initialization failed!\n";
 		}
+#else
+		m_UseSoftwareRasterizer = true;
+		std::cout << "Built without DirectX, software rasterizer only\n";
+#endif
+
+		InitializeSoftwareRasterizer();
+		InitializeScene();
+	}
 
+	Renderer::Renderer(int width, int height) :
+		m_Width(width),
+		m_Height(height),
+		m_RenderWidth(width),
+		m_RenderHeight(height),
+		m_IsHeadless(true),
+		m_UseSoftwareRasterizer(true),
+		m_SpecularMode(SpecularMode::exact),
+		m_DepthFormat(DepthFormat::float32)
+	{
+		// No window & no device, textures and meshes only load what the software rasterizer needs
 		InitializeSoftwareRasterizer();
+		InitializeScene();
+	}
 
+	void Renderer::InitializeScene()
+	{
 		// VEHICLE
 		// 1) Load textures
 		m_pVehicleDiffuse	= new Texture{ "Resources/vehicle_diffuse.png", m_pDevice };
@@ -44,21 +86,30 @@ namespace dae
 		m_pVehicleNormal	= new Texture{ "Resources/vehicle_normal.png",	m_pDevice };
 		m_pVehicleSpecular	= new Texture{ "Resources/vehicle_specular.png", m_pDevice };
 
+		// Interleaved copy of the four maps for the software rasterizer
+		m_pVehicleMaterial	= new MaterialBundle{ m_pVehicleDiffuse, m_pVehicleNormal, m_pVehicleSpecular, m_pVehicleGloss };
+		m_pSpecularEvaluator = new SpecularEvaluator{ 25.f }; // Shininess
+
 		// 2) Load mesh
 		m_pVehicle = new Mesh<Vertex_PosTex>{ m_pDevice, "Resources/vehicle.obj", EffectType::PosTex };
 
 		// 3) Set mesh translation
 		m_pVehicle->SetWorldMatrix(Matrix::CreateTranslation(0, 0, 50.f));
 
-		// 4) Link textures to effect
-		m_pVehicle->GetEffect()->AddMap("gDiffuseMap", m_pVehicleDiffuse);
-		m_pVehicle->GetEffect()->AddMap("gNormalMap", m_pVehicleNormal);
-		m_pVehicle->GetEffect()->AddMap("gSpecularMap", m_pVehicleGloss);
-		m_pVehicle->GetEffect()->AddMap("gGlossinessMap", m_pVehicleSpecular);
-
-		// 5) Supplementary techniques for culling
-		m_pVehicle->GetEffect()->AddTechnique("TheGrandTechniqueNOCULL");
-		m_pVehicle->GetEffect()->AddTechnique("TheGrandTechniqueFRONTCULL");
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless)
+		{
+			// 4) Link textures to effect
+			m_pVehicle->GetEffect()->AddMap("gDiffuseMap", m_pVehicleDiffuse);
+			m_pVehicle->GetEffect()->AddMap("gNormalMap", m_pVehicleNormal);
+			m_pVehicle->GetEffect()->AddMap("gSpecularMap", m_pVehicleGloss);
+			m_pVehicle->GetEffect()->AddMap("gGlossinessMap", m_pVehicleSpecular);
+
+			// 5) Supplementary techniques for culling
+			m_pVehicle->GetEffect()->AddTechnique("TheGrandTechniqueNOCULL");
+			m_pVehicle->GetEffect()->AddTechnique("TheGrandTechniqueFRONTCULL");
+		}
+#endif
 
 
 
@@ -73,7 +124,9 @@ namespace dae
 		m_pFireEffect->SetWorldMatrix(Matrix::CreateTranslation(0, 0, 50.f));
 
 		// 4) Link textures to effect
-		m_pFireEffect->GetEffect()->AddMap("gDiffuseMap", m_pFireDiffuse);
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless) m_pFireEffect->GetEffect()->AddMap("gDiffuseMap", m_pFireDiffuse);
+#endif
 
 
 
@@ -82,12 +135,30 @@ namespace dae
 		m_pCamera->Initialize(45.f, { 0.f, 0.f, 0.f }, static_cast<float>(m_Width) / static_cast<float>(m_Height));
 		m_pCamera->CalculateProjectionMatrix();
 		m_pCamera->CalculateViewMatrix();
+
+		// LIGHTS
+		Light keyLight{};
+		keyLight.type = LightType::directional;
+		keyLight.direction = { .577f, -.577f, .577f };
+		keyLight.intensity = 7.f;
+		AddLight(keyLight);
 	}
 
 	Renderer::~Renderer()
 	{
-		delete[] m_pDepthBufferPixels;
+		SAFE_DELETE(m_pPresenter) // Joins the present thread, before anything it presents goes away
+		SAFE_DELETE(m_pWorkerPool)
+		SAFE_DELETE(m_SyncTarget.pDepth)
+		delete[] m_pHeatmapCounts;
+		delete[] m_pHeatmapTileTimes;
+		delete[] m_pTileShadingRates;
+		delete[] m_pSampleColors;
+		SAFE_DELETE(m_pSampleDepth)
+		delete[] m_SyncTarget.pTileEpochs;
+		if (!m_IsRenderingIntoFrontBuffer) SDL_FreeSurface(m_SyncTarget.pColor); // The window owns its own surface
+#ifndef DISABLE_DIRECTX
 		ReleaseDirectXResources();
+#endif
 		SAFE_DELETE(m_pMesh)
 		SAFE_DELETE(m_pFireEffect)
 		SAFE_DELETE(m_pCamera)
@@ -96,29 +167,121 @@ namespace dae
 		SAFE_DELETE(m_pVehicleGloss)
 		SAFE_DELETE(m_pVehicleSpecular)
 		SAFE_DELETE(m_pVehicleNormal)
+		SAFE_DELETE(m_pVehicleMaterial)
+		SAFE_DELETE(m_pSpecularEvaluator)
+		SAFE_DELETE(m_pLightCuller)
+		SAFE_DELETE(m_pFramebufferWriter)
+		SAFE_DELETE(m_pUpscaler)
+		SAFE_DELETE(m_pDynamicResolution)
+		SAFE_DELETE(m_pFxaaPass)
 		SAFE_DELETE(m_pFireDiffuse)
+		SAFE_DELETE(m_pProfiler)
 	}
 
 	void Renderer::Update(const Timer* pTimer)
 	{
-		const float deltaTime{ pTimer->GetElapsed() };
-		m_pCamera->Update(deltaTime);
+		Update(pTimer->GetElapsed());
+	}
+
+	void Renderer::Update(float deltaTime)
+	{
+		TraceScope traceScope{ "Renderer::Update" };
+
+		// Headless cameras only move through SetCameraPose, no input to read
+		if (!m_IsHeadless) m_pCamera->Update(deltaTime);
 		if (m_IsMeshRotating)
 		{
 			m_pVehicle->UpdateRotation(deltaTime);
 			m_pFireEffect->UpdateRotation(deltaTime);
+			if (m_pMesh) m_pMesh->UpdateRotation(deltaTime);
 		}
 
-		m_pVehicle->VerticesToProjectionSpace(m_pCamera->viewMatrix, m_pCamera->projectionMatrix, m_pCamera->origin);
+		// Only software frames get profiled, the frame ends in SoftwareRender
+		if (m_UseSoftwareRasterizer) m_pProfiler->BeginFrame();
+
+		// Hardware frames never begin a profiled frame, a stage opened there would leak into the next software frame
+		if (m_UseSoftwareRasterizer) m_pProfiler->BeginStage(ProfileStage::vertexTransform);
+		GetRasterizedMesh()->VerticesToProjectionSpace(m_pCamera->viewMatrix, m_pCamera->projectionMatrix, m_pCamera->origin, GetKeyLightDirection());
+		if (m_UseSoftwareRasterizer) m_pProfiler->EndStage();
+
+		if (m_UseSoftwareRasterizer)
+		{
+			ProfileScope profileScope{ m_pProfiler, ProfileStage::binning };
+			m_pLightCuller->Cull(m_Lights, *m_pCamera);
+		}
 
+#ifndef DISABLE_DIRECTX
 		m_pVehicle->UpdateEffectMatrices(m_pCamera);
 		m_pFireEffect->UpdateEffectMatrices(m_pCamera);
+#endif
+	}
+
+	void Renderer::SetStressMesh(Mesh<Vertex_PosTex>* pMesh)
+	{
+		SAFE_DELETE(m_pMesh)
+		m_pMesh = pMesh;
+
+		// Same spot as the vehicle, so the camera paths keep working
+		if (m_pMesh) m_pMesh->SetWorldMatrix(Matrix::CreateTranslation(0, 0, 50.f));
+	}
+
+	Mesh<Vertex_PosTex>* Renderer::GetRasterizedMesh() const
+	{
+		return m_pMesh ? m_pMesh : m_pVehicle;
+	}
+
+	void Renderer::SetCameraPose(const Vector3& origin, float pitch, float yaw)
+	{
+		m_pCamera->SetPose(origin, pitch, yaw);
+	}
+
+	void Renderer::Resize(int width, int height)
+	{
+		if (width <= 0 || height <= 0 || (width == m_Width && height == m_Height)) return;
+
+		// Nothing may still be presenting out of the old targets or window surface
+		if (m_pPresenter) m_pPresenter->Flush();
+
+		m_Width = width;
+		m_Height = height;
+		m_pCamera->SetAspectRatio(static_cast<float>(m_Width) / static_cast<float>(m_Height));
+
+		// HARDWARE
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless && m_IsInitialized && FAILED(ResizeDirectXTargets()))
+		{
+			ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_GREEN);
+			std::cout << "**(HARDWARE) Resizing the swap chain failed!" << std::endl;
+		}
+#endif
+
+		// SOFTWARE, the window surface changed even when the scaled size didn't
+		UpdateRenderSize();
+		ResizeSoftwareTargets();
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
+		std::cout << "**(SHARED) Resolution = " << m_Width << 'x' << m_Height << std::endl;
 	}
 
-	void Renderer::Render() const
+	void Renderer::SetRenderScale(float renderScale)
 	{
-		if(m_UseSoftwareRasterizer)	SoftwareRender();
-		else						HardwareRender();
+		m_RenderScale = std::clamp(renderScale, .1f, 1.f);
+		if (UpdateRenderSize()) ResizeSoftwareTargets();
+	}
+
+	void Renderer::Render()
+	{
+		TraceScope traceScope{ "Renderer::Render" };
+
+		if (m_UseSoftwareRasterizer)
+		{
+			SoftwareRender();
+			if (m_UseDynamicResolution) UpdateDynamicResolution();
+		}
+		else
+		{
+			HardwareRender();
+		}
 	}
 
 	void Renderer::CycleShadingModes()
@@ -130,8 +293,7 @@ namespace dae
 			m_ShadingMode = static_cast<ShadingMode>(0);
 		}
 
-		// Dynamic_cast seems justifiable due to it being only used on a keypress, and not having to implement SetShadingMode in the Effect base class
-		dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetShadingMode(static_cast<int>(m_ShadingMode));
+		SetShadingMode(m_ShadingMode);
 
 		// Console logging:
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
@@ -154,10 +316,22 @@ namespace dae
 		}
 	}
 
+	void Renderer::SetShadingMode(ShadingMode shadingMode)
+	{
+		m_ShadingMode = shadingMode;
+
+		// Dynamic_cast seems justifiable due to it being only used on a keypress, and not having to implement SetShadingMode in the Effect base class
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless) dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetShadingMode(static_cast<int>(m_ShadingMode));
+#endif
+	}
+
 	void Renderer::ToggleUseNormalMaps()
 	{
 		m_IsUsingNormalMap = !m_IsUsingNormalMap;
-		dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetUseNormalMap(m_IsUsingNormalMap);
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless) dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetUseNormalMap(m_IsUsingNormalMap);
+#endif
 
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
 		std::cout << "**(SHARED) NormalMap " << (m_IsUsingNormalMap ? "ON" : "OFF") << std::endl;
@@ -173,10 +347,18 @@ namespace dae
 
 	void Renderer::ToggleRasterizer()
 	{
+		if (m_IsHeadless) return; // Nothing to switch to
+
+#ifndef DISABLE_DIRECTX
 		m_UseSoftwareRasterizer = !m_UseSoftwareRasterizer;
+		if (!m_UseSoftwareRasterizer) m_pPresenter->Flush(); // DirectX takes the window back
 
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
 		std::cout << "**(SHARED)Rasterizer Mode = " << (m_UseSoftwareRasterizer ? "SOFTWARE" : "HARDWARE") << std::endl;
+#else
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
+		std::cout << "**(SHARED) Built without DirectX, software rasterizer only" << std::endl;
+#endif
 	}
 
 	void Renderer::ToggleUniformColor()
@@ -196,8 +378,7 @@ namespace dae
 		// Correct if set to ENUM_END in cycle
 		if (m_CullingMode == CullingMode::ENUM_END) m_CullingMode = static_cast<CullingMode>(0);
 
-		// Set Hardware culling mode
-		dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetCullingMode(m_CullingMode);
+		SetCullingMode(m_CullingMode);
 
 		// Console logging
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
@@ -216,12 +397,103 @@ namespace dae
 			break;
 		}
 	}
+
+	void Renderer::SetCullingMode(CullingMode cullingMode)
+	{
+		m_CullingMode = cullingMode;
+
+		// Set Hardware culling mode
+#ifndef DISABLE_DIRECTX
+		if (!m_IsHeadless) dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetCullingMode(m_CullingMode);
+#endif
+	}
+
+	void Renderer::AddLight(const Light& light)
+	{
+		m_Lights.emplace_back(light);
+		if (light.type != LightType::directional) m_HasLocalLights = true;
+
+		if (m_KeyLightIdx < 0 && light.type == LightType::directional)
+		{
+			m_KeyLightIdx = static_cast<int>(m_Lights.size()) - 1;
+			UpdateHardwareKeyLight();
+		}
+	}
+
+	void Renderer::ClearLights()
+	{
+		m_Lights.clear();
+		m_HasLocalLights = false;
+		m_KeyLightIdx = -1;
+		UpdateHardwareKeyLight();
+	}
+
+	const std::vector<Light>& Renderer::GetLights() const
+	{
+		return m_Lights;
+	}
+
+	void Renderer::ToggleLightShowcase()
+	{
+		m_IsShowingLightShowcase = !m_IsShowingLightShowcase;
+
+		// Keep the key light, swap everything else
+		const bool hasKeyLight{ m_KeyLightIdx >= 0 };
+		const Light keyLight{ hasKeyLight ? m_Lights[m_KeyLightIdx] : Light{} };
+		ClearLights();
+		if (hasKeyLight) AddLight(keyLight);
+
+		if (m_IsShowingLightShowcase)
+		{
+			// Fixed seed, so every run shows the same lights
+			std::mt19937 generator{ 1337 };
+			std::uniform_real_distribution<float> xDistribution{ -20.f, 20.f };
+			std::uniform_real_distribution<float> yDistribution{ -6.f, 12.f };
+			std::uniform_real_distribution<float> zDistribution{ 30.f, 70.f };
+			std::uniform_real_distribution<float> colorDistribution{ .2f, 1.f };
+
+			constexpr int nrOfPointLights{ 240 };
+			for (int lightIdx{}; lightIdx < nrOfPointLights; ++lightIdx)
+			{
+				Light pointLight{};
+				pointLight.type = LightType::point;
+				pointLight.origin.x = xDistribution(generator);
+				pointLight.origin.y = yDistribution(generator);
+				pointLight.origin.z = zDistribution(generator);
+				pointLight.color.r = colorDistribution(generator);
+				pointLight.color.g = colorDistribution(generator);
+				pointLight.color.b = colorDistribution(generator);
+				pointLight.intensity = 4.f;
+				pointLight.range = 6.f;
+				AddLight(pointLight);
+			}
+
+			constexpr int nrOfSpotLights{ 16 };
+			for (int lightIdx{}; lightIdx < nrOfSpotLights; ++lightIdx)
+			{
+				Light spotLight{};
+				spotLight.type = LightType::spot;
+				spotLight.origin = { xDistribution(generator), 20.f, zDistribution(generator) };
+				spotLight.direction = -Vector3::UnitY;
+				spotLight.color = { colorDistribution(generator), colorDistribution(generator), colorDistribution(generator) };
+				spotLight.intensity = 10.f;
+				spotLight.range = 30.f;
+				spotLight.cosInnerCone = cosf(15.f * TO_RADIANS);
+				spotLight.cosOuterCone = cosf(25.f * TO_RADIANS);
+				AddLight(spotLight);
+			}
+		}
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
+		std::cout << "**(SHARED) Light Showcase " << (m_IsShowingLightShowcase ? "ON" : "OFF") << " (" << m_Lights.size() << " lights, hardware only uses the key light)" << std::endl;
+	}
 #pragma endregion
 
 	//--------------------------------------
 	// HARDWARE RASTERIZER
 	//--------------------------------------
 #pragma region HARDWARE_RASTERIZER
+#ifndef DISABLE_DIRECTX
 	HRESULT Renderer::InitializeDirectX()
 	{
 		HRESULT result{ InitializeDeviceAndDeviceContext() };
@@ -236,7 +508,12 @@ namespace dae
 		pIdxgiFactory->Release();
 		if (FAILED(result)) return result;
 
-		result = InitializeDepthStencil();
+		return InitializeRenderTargets();
+	}
+
+	HRESULT Renderer::InitializeRenderTargets()
+	{
+		HRESULT result{ InitializeDepthStencil() };
 		if (FAILED(result))	return result;
 
 		result = InitializeDepthStencilView();
@@ -257,6 +534,26 @@ namespace dae
 		return S_OK;
 	}
 
+	HRESULT Renderer::ResizeDirectXTargets()
+	{
+		// The swap chain can only resize once nothing references its buffer anymore
+		m_pDeviceContext->OMSetRenderTargets(0, nullptr, nullptr);
+		if (m_pRenderTargetView)	m_pRenderTargetView->Release();
+		if (m_pRenderTargetBuffer)	m_pRenderTargetBuffer->Release();
+		if (m_pDepthStencilView)	m_pDepthStencilView->Release();
+		if (m_pDepthStencilBuffer)	m_pDepthStencilBuffer->Release();
+		m_pRenderTargetView = nullptr;
+		m_pRenderTargetBuffer = nullptr;
+		m_pDepthStencilView = nullptr;
+		m_pDepthStencilBuffer = nullptr;
+
+		// Keeps the buffer count & format it was created with
+		const HRESULT result{ m_pSwapChain->ResizeBuffers(0, m_Width, m_Height, DXGI_FORMAT_UNKNOWN, 0) };
+		if (FAILED(result)) return result;
+
+		return InitializeRenderTargets();
+	}
+
 	HRESULT Renderer::InitializeDeviceAndDeviceContext()
 	{
 		D3D_FEATURE_LEVEL featureLevel{ D3D_FEATURE_LEVEL_11_1 };
@@ -361,9 +658,22 @@ namespace dae
 			m_pDeviceContext->Release();
 		}
 	}
+#endif
+
+	void Renderer::UpdateHardwareKeyLight()
+	{
+#ifndef DISABLE_DIRECTX
+		if (m_IsHeadless) return;
+
+		// No key light renders unlit, the hardware path has no other lights
+		const Light keyLight{ m_KeyLightIdx >= 0 ? m_Lights[m_KeyLightIdx] : Light{ LightType::directional, {}, -Vector3::UnitY } };
+		dynamic_cast<Effect_PosTex*>(m_pVehicle->GetEffect())->SetKeyLight(keyLight.direction, keyLight.intensity);
+#endif
+	}
 
 	void Renderer::HardwareRender() const
 	{
+#ifndef DISABLE_DIRECTX
 		if (!m_IsInitialized)
 			return;
 		// 1. Clear RTV & DSV
@@ -377,6 +687,7 @@ namespace dae
 
 		// 3. Present backbuffer (swap)
 		m_pSwapChain->Present(0, 0);
+#endif
 	}
 
 	void Renderer::CycleFilteringTechniques()
@@ -387,8 +698,12 @@ namespace dae
 			m_FilteringMode = static_cast<FilteringMode>(0);
 		}
 
+		if (m_IsHeadless) return;
+
+#ifndef DISABLE_DIRECTX
 		m_pVehicle->GetEffect()->SetFilterMode(static_cast<int>(m_FilteringMode));
 		m_pFireEffect->GetEffect()->SetFilterMode(static_cast<int>(m_FilteringMode));
+#endif
 
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_GREEN);
 
@@ -423,32 +738,232 @@ namespace dae
 #pragma region SOFTWARE_RASTERIZER
 	void Renderer::InitializeSoftwareRasterizer()
 	{
-		//Create Buffers
-		m_pFrontBuffer = SDL_GetWindowSurface(m_pWindow);
-		m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-		m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+		m_pProfiler = new FrameProfiler{};
+		m_pLightCuller = new TiledLightCuller{ m_RenderWidth, m_RenderHeight };
+		m_pFramebufferWriter = new FramebufferWriter{};
+		m_pUpscaler = new Upscaler{};
+		m_pDynamicResolution = new DynamicResolution{ DynamicResolution::Settings{} };
+		m_pFxaaPass = new FxaaPass{};
+		m_SyncTarget.pDepth = new DepthBuffer{ m_RenderWidth, m_RenderHeight };
+
+		// Second pair of targets + present thread, only used while async present is on
+		if (!m_IsHeadless) m_pPresenter = new SoftwarePresenter{ m_pWindow, m_RenderWidth, m_RenderHeight };
+
+		AllocateSoftwareTargets();
+		SetWorkerCount(static_cast<int>(std::thread::hardware_concurrency()));
+
+		if (!m_IsHeadless)
+		{
+			ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+			std::cout << "**(SOFTWARE) Present = " << (m_IsRenderingIntoFrontBuffer ? "ZERO-COPY (window surface)" : "BLIT (window surface format differs)") << std::endl;
+		}
+	}
+
+	void Renderer::AllocateMsaaTargets()
+	{
+		// Samples of a pixel sit next to each other, so the sample depth buffer is just m_NrOfSamples times as wide
+		if (m_pSampleDepth) m_pSampleDepth->Resize(m_RenderWidth * m_NrOfSamples, m_RenderHeight);
+		else m_pSampleDepth = new DepthBuffer{ m_RenderWidth * m_NrOfSamples, m_RenderHeight };
+
+		const int nrOfSamples{ m_NrOfPixels * m_NrOfSamples };
+		if (nrOfSamples > m_SampleCapacity)
+		{
+			delete[] m_pSampleColors;
+			m_pSampleColors = new uint32_t[nrOfSamples];
+			m_SampleCapacity = nrOfSamples;
+		}
+	}
+
+	void Renderer::ResizeSoftwareTargets()
+	{
+		// Flushes first, the present thread may still be showing one of the old targets
+		if (m_pPresenter) m_pPresenter->Resize(m_RenderWidth, m_RenderHeight);
+
+		if (!m_IsRenderingIntoFrontBuffer) SDL_FreeSurface(m_SyncTarget.pColor); // A resized window's old surface is already gone
+		m_SyncTarget.pDepth->Resize(m_RenderWidth, m_RenderHeight);
+		m_pLightCuller->Resize(m_RenderWidth, m_RenderHeight);
+		AllocateSoftwareTargets();
+	}
+
+	bool Renderer::UpdateRenderSize()
+	{
+		const int renderWidth{ std::max(static_cast<int>(static_cast<float>(m_Width) * m_RenderScale + .5f), 1) };
+		const int renderHeight{ std::max(static_cast<int>(static_cast<float>(m_Height) * m_RenderScale + .5f), 1) };
+		if (renderWidth == m_RenderWidth && renderHeight == m_RenderHeight) return false;
+
+		m_RenderWidth = renderWidth;
+		m_RenderHeight = renderHeight;
+		return true;
+	}
+
+	void Renderer::UpdateDynamicResolution()
+	{
+		const float renderScale{ m_pDynamicResolution->Update(m_pProfiler->GetLastFrameMs()) };
+		if (renderScale == m_RenderScale) return;
+
+		SetRenderScale(renderScale);
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Render Scale = " << m_RenderScale << " (" << m_RenderWidth << 'x' << m_RenderHeight << ')' << std::endl;
+	}
+
+	void Renderer::AllocateSoftwareTargets()
+	{
+		//Create Buffers, headless renders into its own surface only
+		m_pFrontBuffer = m_IsHeadless ? nullptr : SDL_GetWindowSurface(m_pWindow);
+
+		// Render straight into the window surface when it can be written like our own back buffer, saves a full screen blit every frame
+		m_IsRenderingIntoFrontBuffer = m_pFrontBuffer
+									&& m_pFrontBuffer->w == m_RenderWidth && m_pFrontBuffer->h == m_RenderHeight
+									&& m_pFrontBuffer->pitch == m_RenderWidth * static_cast<int>(sizeof(uint32_t))
+									&& FramebufferWriter::IsSupported(m_pFrontBuffer->format);
+
+		m_SyncTarget.pColor = m_IsRenderingIntoFrontBuffer ? m_pFrontBuffer : SDL_CreateRGBSurface(0, m_RenderWidth, m_RenderHeight, 32, 0, 0, 0, 0);
+		m_SyncTarget.pColorPixels = (uint32_t*)m_SyncTarget.pColor->pixels;
+
+		m_NrOfPixels = m_RenderWidth * m_RenderHeight;
+		m_SyncTarget.nrOfTilesX = (m_RenderWidth + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+		m_SyncTarget.nrOfTilesY = (m_RenderHeight + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+		const int nrOfTiles{ m_SyncTarget.nrOfTilesX * m_SyncTarget.nrOfTilesY };
+
+		// Per pixel & per tile arrays only grow, going back down to a smaller resolution reuses them
+		if (nrOfTiles > m_TileCapacity)
+		{
+			delete[] m_SyncTarget.pTileEpochs;
+			delete[] m_pHeatmapTileTimes;
+			delete[] m_pTileShadingRates;
+			m_SyncTarget.pTileEpochs = new uint32_t[nrOfTiles];
+			m_pHeatmapTileTimes = new uint64_t[nrOfTiles];
+			m_pTileShadingRates = new uint8_t[nrOfTiles];
+			m_TileCapacity = nrOfTiles;
+		}
+		std::fill_n(m_SyncTarget.pTileEpochs, nrOfTiles, 0u);
+		std::fill_n(m_pHeatmapTileTimes, nrOfTiles, 0ull);
+		std::fill_n(m_pTileShadingRates, nrOfTiles, static_cast<uint8_t>(1));
+
+		if (m_NrOfPixels > m_PixelCapacity)
+		{
+			delete[] m_pHeatmapCounts;
+			m_pHeatmapCounts = new uint32_t[m_NrOfPixels];
+			m_PixelCapacity = m_NrOfPixels;
+		}
+		std::fill_n(m_pHeatmapCounts, m_NrOfPixels, 0u);
 
-		m_NrOfPixels = m_Width * m_Height;
-		m_pDepthBufferPixels = new float[m_NrOfPixels];
+		if (m_UseMsaa) AllocateMsaaTargets();
+
+		// Bins keep their triangle vectors (and their capacity) when the count goes down
+		m_NrOfBinsX = (m_RenderWidth + m_BinSize - 1) / m_BinSize;
+		m_NrOfBinsY = (m_RenderHeight + m_BinSize - 1) / m_BinSize;
+		m_BinTriangles.resize(m_NrOfBinsX * m_NrOfBinsY);
 	}
 
-	void Renderer::SoftwareRender() const
+	void Renderer::SoftwareRender()
 	{
-		std::fill_n(m_pDepthBufferPixels, m_NrOfPixels, FLT_MAX);
+		m_pProfiler->BeginStage(ProfileStage::present); // Waiting for a free target is present time as well
+		m_BoundTarget = m_UseAsyncPresent ? m_pPresenter->AcquireTarget() : m_SyncTarget;
+		m_pProfiler->EndStage();
+
+		m_pBackBuffer = m_BoundTarget.pColor;
+		m_pBackBufferPixels = m_BoundTarget.pColorPixels;
+		m_pDepthBuffer = m_BoundTarget.pDepth;
+		m_pDepthBuffer->SetFormat(m_DepthFormat, m_pCamera->nearPlane, m_pCamera->farPlane); // Every target follows the selected format
+		if (m_pSampleDepth) m_pSampleDepth->SetFormat(m_DepthFormat, m_pCamera->nearPlane, m_pCamera->farPlane);
+
+		// No full screen clears, every tile that's not tagged with this frame counts as cleared
+		++m_FrameEpoch;
 
 		ColorRGB clearColor{ m_UseUniformColor ? m_UniformClearColor : m_SoftwareClearColor };
-		SDL_FillRect(m_pBackBuffer, NULL, SDL_MapRGB(m_pBackBuffer->format, static_cast<int>(clearColor.r * 255), static_cast<int>(clearColor.g * 255), static_cast<int>(clearColor.b * 255)));
+		m_pFramebufferWriter->Resolve(m_pBackBuffer->format);
+		m_PackedClearColor = m_pFramebufferWriter->Pack(clearColor);
+
+		if (m_HeatmapMode != HeatmapMode::off)
+		{
+			std::fill_n(m_pHeatmapCounts, m_NrOfPixels, 0u);
+			std::fill_n(m_pHeatmapTileTimes, m_BoundTarget.nrOfTilesX * m_BoundTarget.nrOfTilesY, 0ull);
+		}
 		//@START
 		//Lock BackBuffer
 		SDL_LockSurface(m_pBackBuffer);
 
-		auto& vertsOut{ m_pVehicle->GetVertexOutVector() };
-		const int lastTriangleStartIndex{ static_cast<int>(m_pVehicle->GetNumIndices() - 2) };
-		auto vertIndices{ m_pVehicle->GetIndices() };
+		std::fill(m_ThreadStats.begin(), m_ThreadStats.end(), RasterizerStats{});
+
+		m_pProfiler->BeginStage(ProfileStage::binning);
+		SetupAndBinTriangles(m_ThreadStats[0]);
+		m_pProfiler->EndStage();
+
+		m_pProfiler->BeginStage(ProfileStage::rasterization);
+		TraceRecorder::GetInstance()->Begin("Rasterize");
+
+		// Bins never share a pixel, a clear tile or a quad, so the workers only meet again at the end of the frame
+		m_pWorkerPool->Run(m_NrOfBinsX * m_NrOfBinsY, [this](int binIdx, int workerIdx) { RasterizeBin(binIdx, m_ThreadStats[workerIdx]); });
+	//@END
+		m_FrameStats = {};
+		for (const RasterizerStats& threadStats : m_ThreadStats) m_FrameStats += threadStats;
+		m_pProfiler->AddWorkerTime(ProfileStage::shading, m_FrameStats.shadingTicks, m_pWorkerPool->GetNrOfWorkers());
+		m_pProfiler->AddWorkerTime(ProfileStage::msaaResolve, m_FrameStats.msaaResolveTicks, m_pWorkerPool->GetNrOfWorkers());
+		m_pProfiler->AddWorkerTime(ProfileStage::clear, m_FrameStats.clearTicks, m_pWorkerPool->GetNrOfWorkers());
+
+		TraceRecorder::GetInstance()->End("Rasterize");
+		m_pProfiler->EndStage();
+
+		m_pProfiler->BeginStage(ProfileStage::clear);
+		ResolveUntouchedTiles();
+		m_pProfiler->EndStage();
+
+		// Debug views show raw buffers, smoothing them would only hide what they're there for
+		if (m_UseFxaa && !m_ShowOnlyDepthBuffer && !m_ShowOnlyBoundingBoxes)
+		{
+			m_pProfiler->BeginStage(ProfileStage::antiAliasing);
+			TraceRecorder::GetInstance()->Begin("FXAA");
+			m_pFxaaPass->Apply(m_pBackBufferPixels, m_RenderWidth, m_RenderHeight, m_pBackBuffer->format, m_pWorkerPool);
+			TraceRecorder::GetInstance()->End("FXAA");
+			m_pProfiler->EndStage();
+		}
+
+		if (m_HeatmapMode != HeatmapMode::off) ResolveHeatmap();
+
+	//Update SDL Surface
+		SDL_UnlockSurface(m_pBackBuffer);
+
+		// Headless frames stay in the offscreen target, see GetFramePixels
+		if (m_IsHeadless)
+		{
+			m_pProfiler->EndFrame();
+			return;
+		}
+
+		m_pProfiler->BeginStage(ProfileStage::present);
+		TraceScope traceScope{ "Present" };
+		if (m_UseAsyncPresent)
+		{
+			m_pPresenter->Submit();
+			m_pPresenter->UpdateWindow(); // Usually the previous frame, its blit ran while this one rasterized
+		}
+		else
+		{
+			if (!m_IsRenderingIntoFrontBuffer) m_pUpscaler->Blit(m_pBackBuffer, m_pFrontBuffer); // Upscales when rendering below the window size
+			SDL_UpdateWindowSurface(m_pWindow);
+		}
+		m_pProfiler->EndStage();
+
+		m_pProfiler->EndFrame();
+	}
+
+	void Renderer::SetupAndBinTriangles(RasterizerStats& stats)
+	{
+		Mesh<Vertex_PosTex>* pMesh{ GetRasterizedMesh() };
+		auto& vertsOut{ pMesh->GetVertexOutVector() };
+		const int lastTriangleStartIndex{ static_cast<int>(pMesh->GetNumIndices() - 2) };
+		auto vertIndices{ pMesh->GetIndices() };
+
+		m_SetupTriangles.clear();
+		for (std::vector<uint32_t>& binTriangles : m_BinTriangles) binTriangles.clear();
 
 		// For every triangle
 		for (int vertexIndex{}; vertexIndex < lastTriangleStartIndex; vertexIndex += 3)
 		{
+			++stats.trianglesSubmitted;
+
 			int v1Index{ vertexIndex + 1 };
 			int v2Index{ vertexIndex + 2 };
 
@@ -464,6 +979,7 @@ namespace dae
 				|| v1.position.y > 1.f || v1.position.y < -1.f
 				|| v2.position.y > 1.f || v2.position.y < -1.f)
 			{
+				++stats.frustumRejected;
 				continue;
 			}
 
@@ -471,72 +987,517 @@ namespace dae
 			VertexProjectionToScreenSpace(v1);
 			VertexProjectionToScreenSpace(v2);
 
+			// Degenerate, the weights would divide by 0
+			const float areaParallelogram{Utils::CalcAreaParallelogram(v0, v1, v2) };
+			if (areaParallelogram == 0.f)
+			{
+				++stats.zeroArea;
+				continue;
+			}
+
 			// Check triangle against culling mode
-			if (IsTriangleCulled(v0, v1, v2)) continue;
+			if (IsTriangleCulled(v0, v1, v2))
+			{
+				++stats.backfaceCulled;
+				continue;
+			}
 
 			const Pixel2D boundingBoxMin{ Utils::CalcBoundingBoxMin(v0, v1, v2) };
-			const Pixel2D boundingBoxMax{ Utils::CalcBoundingBoxMax(v0, v1, v2, m_Width, m_Height) };
+			Pixel2D boundingBoxMax{ Utils::CalcBoundingBoxMax(v0, v1, v2, m_RenderWidth, m_RenderHeight) };
 
-			const float areaParallelogram{Utils::CalcAreaParallelogram(v0, v1, v2) };
+			// Samples sit up to 3/8 pixel left of & above the center, the pixel past the max can still have one covered
+			if (IsMsaaActive())
+			{
+				boundingBoxMax.x = std::min(boundingBoxMax.x + 1, m_RenderWidth - 1);
+				boundingBoxMax.y = std::min(boundingBoxMax.y + 1, m_RenderHeight - 1);
+			}
 
-			//RENDER LOGIC
-			// For every pixel of triangle
-			for (int px{ boundingBoxMin.x }; px < boundingBoxMax.x; ++px)
+			// Max is exclusive, nothing to rasterize
+			if (boundingBoxMax.x <= boundingBoxMin.x || boundingBoxMax.y <= boundingBoxMin.y) continue;
+
+			const uint32_t triangleIdx{ static_cast<uint32_t>(m_SetupTriangles.size()) };
+			m_SetupTriangles.push_back({ v0, v1, v2, areaParallelogram, boundingBoxMin, boundingBoxMax });
+
+			for (int binY{ boundingBoxMin.y / m_BinSize }; binY <= (boundingBoxMax.y - 1) / m_BinSize; ++binY)
 			{
-				for (int py{ boundingBoxMin.y }; py < boundingBoxMax.y; ++py)
+				for (int binX{ boundingBoxMin.x / m_BinSize }; binX <= (boundingBoxMax.x - 1) / m_BinSize; ++binX)
 				{
-					RenderPixel(px, py, v0, v1, v2, areaParallelogram);
+					m_BinTriangles[binX + binY * m_NrOfBinsX].push_back(triangleIdx);
 				}
 			}
 		}
-	//@END
-	//Update SDL Surface
-		SDL_UnlockSurface(m_pBackBuffer);
-		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-		SDL_UpdateWindowSurface(m_pWindow);
 	}
 
-	void Renderer::VertexProjectionToScreenSpace(Vertex_Out& vertex) const
+	void Renderer::RasterizeBin(int binIdx, RasterizerStats& stats)
 	{
-		vertex.position.x = (vertex.position.x + 1) / 2 * static_cast<float>(m_Width);
-		vertex.position.y = (1 - vertex.position.y) / 2 * static_cast<float>(m_Height);
-	}
+		const Pixel2D binMin{ (binIdx % m_NrOfBinsX) * m_BinSize, (binIdx / m_NrOfBinsX) * m_BinSize };
+		const Pixel2D binMax{ std::min(binMin.x + m_BinSize, m_RenderWidth), std::min(binMin.y + m_BinSize, m_RenderHeight) };
 
-	bool Renderer::IsTriangleCulled(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2) const
-	{
-		if (m_CullingMode == CullingMode::none) return false; // No senses need to be checked, no culling
+		for (uint32_t triangleIdx : m_BinTriangles[binIdx])
+		{
+			SetupTriangle& triangle{ m_SetupTriangles[triangleIdx] };
 
-		const Vector3 v0toV1{ v1.position - v0.position };
-		const Vector3 v0toV2{ v2.position - v0.position };
-		const float sign{ Vector3::Cross(v0toV1, v0toV2).z };
+			// Part of the bounding box inside this bin
+			const Pixel2D rectMin{ std::max(triangle.boundingBoxMin.x, binMin.x), std::max(triangle.boundingBoxMin.y, binMin.y) };
+			const Pixel2D rectMax{ std::min(triangle.boundingBoxMax.x, binMax.x), std::min(triangle.boundingBoxMax.y, binMax.y) };
 
-		switch(m_CullingMode)
+			ClearTilesOnFirstTouch(rectMin, rectMax, stats);
+
+			//RENDER LOGIC
+			if (m_HeatmapMode != HeatmapMode::tileTime)
+			{
+				RasterizeRect(rectMin, rectMax, triangle.boundingBoxMin, triangle.boundingBoxMax, triangle.v0, triangle.v1, triangle.v2, triangle.area, stats);
+				continue;
+			}
+
+			// Tile by tile, so every tile knows exactly how long it took
+			constexpr int tileSize{ RenderTarget::clearTileSize };
+			for (int tileY{ rectMin.y / tileSize }; tileY * tileSize < rectMax.y; ++tileY)
+			{
+				for (int tileX{ rectMin.x / tileSize }; tileX * tileSize < rectMax.x; ++tileX)
+				{
+					const Pixel2D tileRectMin{ std::max(tileX * tileSize, rectMin.x), std::max(tileY * tileSize, rectMin.y) };
+					const Pixel2D tileRectMax{ std::min((tileX + 1) * tileSize, rectMax.x), std::min((tileY + 1) * tileSize, rectMax.y) };
+
+					const uint64_t startTime{ SDL_GetPerformanceCounter() };
+					RasterizeRect(tileRectMin, tileRectMax, triangle.boundingBoxMin, triangle.boundingBoxMax, triangle.v0, triangle.v1, triangle.v2, triangle.area, stats);
+					m_pHeatmapTileTimes[tileX + tileY * m_BoundTarget.nrOfTilesX] += SDL_GetPerformanceCounter() - startTime;
+				}
+			}
+		}
+
+		// The bin's tiles are final now, the samples get resolved & their contrast picks next frame's rates
+		if (IsMsaaActive())
 		{
-		case CullingMode::back:
-			if (sign <= 0 )return true;
-			return false;
-		case CullingMode::front:
-			if (sign >= 0) return true;
-			return false;
-		default:
-			std::cout << "Something went wrong! CullingMode seems to be set to value that's not in Enum!\n";
-			return true; // Oh no! Everything gets culled
+			const uint64_t startTicks{ SDL_GetPerformanceCounter() };
+			ResolveMsaaTiles(binMin, binMax);
+			stats.msaaResolveTicks += SDL_GetPerformanceCounter() - startTicks;
 		}
+		if (m_ShadingRate == ShadingRate::adaptive) UpdateTileShadingRates(binMin, binMax);
 	}
 
-	void Renderer::RenderPixel(int px, int py, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area) const
+	void Renderer::RasterizeRect(const Pixel2D& rectMin, const Pixel2D& rectMax, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area, RasterizerStats& stats) const
 	{
-		ColorRGB finalColor{};
-		if(m_ShowOnlyBoundingBoxes)
+		// Quads as well, so the shading still runs four pixels wide. Takes precedence over coarse shading
+		if (IsMsaaActive())
 		{
-			finalColor = { 1.f, 1.f, 1.f };
-			//Update Color in Buffer
-			finalColor.MaxToOne();
+			for (int py{ rectMin.y & ~1 }; py < rectMax.y; py += 2)
+			{
+				for (int px{ rectMin.x & ~1 }; px < rectMax.x; px += 2)
+				{
+					RenderMsaaQuad(px, py, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, stats);
+				}
+			}
+			return;
+		}
 
-			m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-				static_cast<uint8_t>(finalColor.r * 255),
-				static_cast<uint8_t>(finalColor.g * 255),
-				static_cast<uint8_t>(finalColor.b * 255));
+		// Coarse blocks are built out of quads, so every rate but full runs on the quad path, SIMD toggle or not
+		if (m_ShadingRate != ShadingRate::full && !m_ShowOnlyBoundingBoxes && !m_ShowOnlyDepthBuffer)
+		{
+			RasterizeRectCoarse(rectMin, rectMax, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, stats);
+			return;
+		}
+
+		if (m_UseSimdShading && !m_ShowOnlyBoundingBoxes)
+		{
+			// For every 2x2 quad touching the rect, quads start on even pixels so they never straddle a light tile
+			for (int py{ rectMin.y & ~1 }; py < rectMax.y; py += 2)
+			{
+				for (int px{ rectMin.x & ~1 }; px < rectMax.x; px += 2)
+				{
+					RenderQuad(px, py, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, stats);
+				}
+			}
+		}
+		else
+		{
+			// For every pixel of triangle
+			for (int px{ rectMin.x }; px < rectMax.x; ++px)
+			{
+				for (int py{ rectMin.y }; py < rectMax.y; ++py)
+				{
+					RenderPixel(px, py, v0, v1, v2, area, stats);
+				}
+			}
+		}
+	}
+
+	void Renderer::ResolveHeatmap() const
+	{
+		if (m_HeatmapMode == HeatmapMode::tileTime)
+		{
+			// Relative to the slowest tile of this frame
+			const int nrOfTiles{ m_BoundTarget.nrOfTilesX * m_BoundTarget.nrOfTilesY };
+			const uint64_t maxTileTime{ std::max<uint64_t>(*std::max_element(m_pHeatmapTileTimes, m_pHeatmapTileTimes + nrOfTiles), 1) };
+
+			for (int py{}; py < m_RenderHeight; ++py)
+			{
+				for (int px{}; px < m_RenderWidth; ++px)
+				{
+					const int tileIdx{ px / RenderTarget::clearTileSize + (py / RenderTarget::clearTileSize) * m_BoundTarget.nrOfTilesX };
+					const float heat{ static_cast<float>(m_pHeatmapTileTimes[tileIdx]) / static_cast<float>(maxTileTime) };
+					m_pBackBufferPixels[px + py * m_RenderWidth] = m_pFramebufferWriter->Pack(Utils::HeatmapColor(heat));
+				}
+			}
+			return;
+		}
+
+		// Fixed scale so frames can be compared, everything from 8 up is red
+		constexpr float maxCount{ 8.f };
+		for (int pixelIdx{}; pixelIdx < m_NrOfPixels; ++pixelIdx)
+		{
+			m_pBackBufferPixels[pixelIdx] = m_pFramebufferWriter->Pack(Utils::HeatmapColor(static_cast<float>(m_pHeatmapCounts[pixelIdx]) / maxCount));
+		}
+	}
+
+	void Renderer::ClearTilesOnFirstTouch(const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, RasterizerStats& stats)
+	{
+		// Max is exclusive, both rasterization paths stay inside [min, max)
+		if (boundingBoxMax.x <= boundingBoxMin.x || boundingBoxMax.y <= boundingBoxMin.y) return;
+
+		const int firstTileX{ boundingBoxMin.x / RenderTarget::clearTileSize };
+		const int firstTileY{ boundingBoxMin.y / RenderTarget::clearTileSize };
+		const int lastTileX{ (boundingBoxMax.x - 1) / RenderTarget::clearTileSize };
+		const int lastTileY{ (boundingBoxMax.y - 1) / RenderTarget::clearTileSize };
+
+		for (int tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+		{
+			for (int tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+			{
+				uint32_t& tileEpoch{ m_BoundTarget.pTileEpochs[tileX + tileY * m_BoundTarget.nrOfTilesX] };
+				if (tileEpoch == m_FrameEpoch) continue;
+
+				tileEpoch = m_FrameEpoch;
+
+				const uint64_t startTicks{ SDL_GetPerformanceCounter() };
+				ClearTile(tileX, tileY, true);
+				stats.clearTicks += SDL_GetPerformanceCounter() - startTicks;
+			}
+		}
+	}
+
+	void Renderer::ResolveUntouchedTiles()
+	{
+		// Nothing got drawn there, so the depth can stay stale until a triangle touches the tile in a later frame
+		for (int tileY{}; tileY < m_BoundTarget.nrOfTilesY; ++tileY)
+		{
+			for (int tileX{}; tileX < m_BoundTarget.nrOfTilesX; ++tileX)
+			{
+				if (m_BoundTarget.pTileEpochs[tileX + tileY * m_BoundTarget.nrOfTilesX] != m_FrameEpoch) ClearTile(tileX, tileY, false);
+			}
+		}
+	}
+
+	void Renderer::ClearTile(int tileX, int tileY, bool clearDepth)
+	{
+		const int startX{ tileX * RenderTarget::clearTileSize };
+		const int startY{ tileY * RenderTarget::clearTileSize };
+		const int tileWidth{ std::min(RenderTarget::clearTileSize, m_RenderWidth - startX) };
+		const int endY{ std::min(startY + RenderTarget::clearTileSize, m_RenderHeight) };
+
+		for (int py{ startY }; py < endY; ++py)
+		{
+			const int rowStart{ startX + py * m_RenderWidth };
+			std::fill_n(m_pBackBufferPixels + rowStart, tileWidth, m_PackedClearColor);
+			if (clearDepth) m_pDepthBuffer->ClearRow(rowStart, tileWidth);
+
+			// A row of pixels is a contiguous run of samples
+			if (clearDepth && IsMsaaActive())
+			{
+				std::fill_n(m_pSampleColors + rowStart * m_NrOfSamples, tileWidth * m_NrOfSamples, m_PackedClearColor);
+				m_pSampleDepth->ClearRow(rowStart * m_NrOfSamples, tileWidth * m_NrOfSamples);
+			}
+		}
+	}
+
+	void Renderer::VertexProjectionToScreenSpace(Vertex_Out& vertex) const
+	{
+		vertex.position.x = (vertex.position.x + 1) / 2 * static_cast<float>(m_RenderWidth);
+		vertex.position.y = (1 - vertex.position.y) / 2 * static_cast<float>(m_RenderHeight);
+	}
+
+	Vector3 Renderer::GetKeyLightDirection() const
+	{
+		// Any unit vector will do without a key light, nothing reads the per vertex light direction then
+		return m_KeyLightIdx >= 0 ? m_Lights[m_KeyLightIdx].direction : -Vector3::UnitY;
+	}
+
+	bool Renderer::IsTriangleCulled(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2) const
+	{
+		if (m_CullingMode == CullingMode::none) return false; // No senses need to be checked, no culling
+
+		const Vector3 v0toV1{ v1.position - v0.position };
+		const Vector3 v0toV2{ v2.position - v0.position };
+		const float sign{ Vector3::Cross(v0toV1, v0toV2).z };
+
+		switch(m_CullingMode)
+		{
+		case CullingMode::back:
+			if (sign <= 0 )return true;
+			return false;
+		case CullingMode::front:
+			if (sign >= 0) return true;
+			return false;
+		default:
+			std::cout << "Something went wrong! CullingMode seems to be set to value that's not in Enum!\n";
+			return true; // Oh no! Everything gets culled
+		}
+	}
+
+	Renderer::QuadWeights Renderer::CalculateClampedWeights(const FloatX4& pixelX, const FloatX4& pixelY, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area) const
+	{
+		// Negative weights clamped & the rest renormalized, which moves a point outside the triangle onto its closest edge or corner (near enough)
+		QuadWeights weights{};
+		weights.v0 = FloatX4::Max(Utils::CalcWeightX4(v1, v2, pixelX, pixelY, area), 0.f);
+		weights.v1 = FloatX4::Max(Utils::CalcWeightX4(v2, v0, pixelX, pixelY, area), 0.f);
+		weights.v2 = FloatX4::Max(Utils::CalcWeightX4(v0, v1, pixelX, pixelY, area), 0.f);
+
+		const FloatX4 weightSum{ weights.v0 + weights.v1 + weights.v2 };
+		weights.v0 = weights.v0 / weightSum;
+		weights.v1 = weights.v1 / weightSum;
+		weights.v2 = weights.v2 / weightSum;
+		weights.z = Utils::InterpolateX4(v0.position.z, v1.position.z, v2.position.z, weights.v0, weights.v1, weights.v2);
+		weights.w = Utils::InterpolateX4(v0.position.w, v1.position.w, v2.position.w, weights.v0, weights.v1, weights.v2);
+		return weights;
+	}
+
+	void Renderer::RenderMsaaQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		// Samples of the quad's four pixels, a pixel gets shaded when any of its samples passed
+		int sampleMasks[4]{};
+		int pixelMask{};
+		for (int lane{}; lane < 4; ++lane)
+		{
+			const int x{ px + (lane & 1) };
+			const int y{ py + (lane >> 1) };
+			if (x < boundingBoxMin.x || x >= boundingBoxMax.x || y < boundingBoxMin.y || y >= boundingBoxMax.y) continue;
+
+			sampleMasks[lane] = TestSamples(x, y, v0, v1, v2, area, stats);
+			if (sampleMasks[lane] != 0) pixelMask |= 1 << lane;
+		}
+
+		if (pixelMask == 0)
+		{
+			return;
+		}
+
+		// Once per pixel at its center, pulled onto the triangle for pixels it only partly covers
+		const float left{ static_cast<float>(px) };
+		const float top{ static_cast<float>(py) };
+		const FloatX4 pixelX{ left, left + 1.f, left, left + 1.f };
+		const FloatX4 pixelY{ top, top, top + 1.f, top + 1.f };
+		const FragmentQuad quad{ InterpolateQuad(px, py, pixelMask, CalculateClampedWeights(pixelX, pixelY, v0, v1, v2, area), v0, v1, v2) };
+
+		if (m_HeatmapMode == HeatmapMode::shadingInvocations)
+		{
+			for (int lane{}; lane < 4; ++lane)
+			{
+				if (pixelMask & (1 << lane)) ++m_pHeatmapCounts[px + (lane & 1) + (py + (lane >> 1)) * m_RenderWidth];
+			}
+		}
+		stats.shadedFragments += std::popcount(static_cast<unsigned>(pixelMask));
+		stats.textureSamples += 4;
+
+		ColorRGBX4 finalColor{};
+		{
+			SampledProfileScope profileScope{ stats.shadingSampleCounter, stats.shadingTicks };
+			finalColor = ShadeQuad(quad);
+		}
+
+		// Every sample that passed gets its pixel's color, the resolve averages them at the end of the bin
+		alignas(16) uint32_t packedColors[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(packedColors), m_pFramebufferWriter->PackX4(finalColor));
+		for (int lane{}; lane < 4; ++lane)
+		{
+			if (!(pixelMask & (1 << lane))) continue;
+
+			uint32_t* pSamples{ m_pSampleColors + (px + (lane & 1) + (py + (lane >> 1)) * m_RenderWidth) * m_NrOfSamples };
+			for (int sampleIdx{}; sampleIdx < m_NrOfSamples; ++sampleIdx)
+			{
+				if (sampleMasks[lane] & (1 << sampleIdx)) pSamples[sampleIdx] = packedColors[lane];
+			}
+		}
+	}
+
+	int Renderer::TestSamples(int px, int py, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		++stats.pixelsTested;
+
+		// Rotated grid, the usual 4x pattern, one sample per lane
+		const float x{ static_cast<float>(px) };
+		const float y{ static_cast<float>(py) };
+		const FloatX4 sampleX{ x - .125f, x + .375f, x - .375f, x + .125f };
+		const FloatX4 sampleY{ y - .375f, y - .125f, y + .125f, y + .375f };
+
+		const FloatX4 weightV0{ Utils::CalcWeightX4(v1, v2, sampleX, sampleY, area) };
+		const FloatX4 weightV1{ Utils::CalcWeightX4(v2, v0, sampleX, sampleY, area) };
+		const FloatX4 weightV2{ Utils::CalcWeightX4(v0, v1, sampleX, sampleY, area) };
+
+		int mask{ ((weightV0 >= 0.f) & (weightV1 >= 0.f) & (weightV2 >= 0.f)).MoveMask() };
+		if (mask == 0)
+		{
+			return 0;
+		}
+		++stats.pixelsCovered;
+
+		// Depth per sample, in the sample depth buffer
+		const FloatX4 zDepth{ Utils::InterpolateX4(v0.position.z, v1.position.z, v2.position.z, weightV0, weightV1, weightV2) };
+		mask &= ((zDepth >= 0.f) & (zDepth <= 1.f)).MoveMask();
+		const FloatX4 wDepth{ Utils::InterpolateX4(v0.position.w, v1.position.w, v2.position.w, weightV0, weightV1, weightV2) };
+
+		alignas(16) float zLanes[4];
+		alignas(16) float wLanes[4];
+		zDepth.Store(zLanes);
+		wDepth.Store(wLanes);
+		const int pixelIdx{ px + py * m_RenderWidth };
+		for (int sampleIdx{}; sampleIdx < m_NrOfSamples; ++sampleIdx)
+		{
+			if (!(mask & (1 << sampleIdx))) continue;
+
+			if (m_HeatmapMode == HeatmapMode::depthTests) ++m_pHeatmapCounts[pixelIdx];
+			if (!m_pSampleDepth->TestAndWrite(pixelIdx * m_NrOfSamples + sampleIdx, zLanes[sampleIdx], wLanes[sampleIdx])) mask &= ~(1 << sampleIdx);
+		}
+
+		if (mask != 0) ++stats.depthPasses;
+		return mask;
+	}
+
+	void Renderer::ResolveMsaaTiles(const Pixel2D& binMin, const Pixel2D& binMax) const
+	{
+		const __m128i zero{ _mm_setzero_si128() };
+		const __m128i rounding{ _mm_set1_epi16(2) };
+
+		constexpr int tileSize{ RenderTarget::clearTileSize };
+		for (int tileY{ binMin.y / tileSize }; tileY * tileSize < binMax.y; ++tileY)
+		{
+			for (int tileX{ binMin.x / tileSize }; tileX * tileSize < binMax.x; ++tileX)
+			{
+				// Untouched tiles get the clear color from ResolveUntouchedTiles, their samples are stale
+				if (m_BoundTarget.pTileEpochs[tileX + tileY * m_BoundTarget.nrOfTilesX] != m_FrameEpoch) continue;
+
+				const int startX{ tileX * tileSize };
+				const int startY{ tileY * tileSize };
+				const int endX{ std::min(startX + tileSize, m_RenderWidth) };
+				const int endY{ std::min(startY + tileSize, m_RenderHeight) };
+
+				for (int py{ startY }; py < endY; ++py)
+				{
+					for (int px{ startX }; px < endX; ++px)
+					{
+						// A pixel's four samples are one 16 byte load, summed per channel in 16 bit lanes
+						const int pixelIdx{ px + py * m_RenderWidth };
+						const __m128i samples{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_pSampleColors + pixelIdx * m_NrOfSamples)) };
+						const __m128i pairSum{ _mm_add_epi16(_mm_unpacklo_epi8(samples, zero), _mm_unpackhi_epi8(samples, zero)) };
+						const __m128i sum{ _mm_add_epi16(pairSum, _mm_srli_si128(pairSum, 8)) };
+						const __m128i average{ _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2) };
+
+						m_pBackBufferPixels[pixelIdx] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(average, average)));
+					}
+				}
+			}
+		}
+	}
+
+	void Renderer::RasterizeRectCoarse(const Pixel2D& rectMin, const Pixel2D& rectMax, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		// Clear tile by clear tile, in adaptive mode every one has its own rate
+		constexpr int tileSize{ RenderTarget::clearTileSize };
+		for (int tileY{ rectMin.y / tileSize }; tileY * tileSize < rectMax.y; ++tileY)
+		{
+			for (int tileX{ rectMin.x / tileSize }; tileX * tileSize < rectMax.x; ++tileX)
+			{
+				const Pixel2D tileRectMin{ std::max(tileX * tileSize, rectMin.x), std::max(tileY * tileSize, rectMin.y) };
+				const Pixel2D tileRectMax{ std::min((tileX + 1) * tileSize, rectMax.x), std::min((tileY + 1) * tileSize, rectMax.y) };
+				const int rate{ GetTileShadingRate(tileX, tileY) };
+
+				// Blocks start on multiples of their size, so they stay inside the tile. Pixels outside the rect are outside the bounding box
+				const int blockSize{ 2 * rate };
+				for (int py{ tileRectMin.y & ~(blockSize - 1) }; py < tileRectMax.y; py += blockSize)
+				{
+					for (int px{ tileRectMin.x & ~(blockSize - 1) }; px < tileRectMax.x; px += blockSize)
+					{
+						if (rate == 1) RenderQuad(px, py, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, stats);
+						else RenderCoarseBlock(px, py, rate, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, stats);
+					}
+				}
+			}
+		}
+	}
+
+	int Renderer::GetTileShadingRate(int tileX, int tileY) const
+	{
+		switch (m_ShadingRate)
+		{
+		case ShadingRate::coarse2x2:	return 2;
+		case ShadingRate::coarse4x4:	return 4;
+		case ShadingRate::adaptive:		return m_pTileShadingRates[tileX + tileY * m_BoundTarget.nrOfTilesX];
+		case ShadingRate::full:
+		case ShadingRate::ENUM_END:		break;
+		}
+		return 1;
+	}
+
+	void Renderer::UpdateTileShadingRates(const Pixel2D& binMin, const Pixel2D& binMax)
+	{
+		constexpr int tileSize{ RenderTarget::clearTileSize };
+		for (int tileY{ binMin.y / tileSize }; tileY * tileSize < binMax.y; ++tileY)
+		{
+			for (int tileX{ binMin.x / tileSize }; tileX * tileSize < binMax.x; ++tileX)
+			{
+				// Untouched tiles only get the clear color, whatever rate they had still applies
+				const int tileIdx{ tileX + tileY * m_BoundTarget.nrOfTilesX };
+				if (m_BoundTarget.pTileEpochs[tileIdx] != m_FrameEpoch) continue;
+
+				const int startX{ tileX * tileSize };
+				const int startY{ tileY * tileSize };
+				const int endX{ std::min(startX + tileSize, m_RenderWidth) };
+				const int endY{ std::min(startY + tileSize, m_RenderHeight) };
+
+				// Per byte min & max over the tile, the channel order doesn't matter for the spread
+				__m128i minBytes{ _mm_set1_epi8(static_cast<char>(0xFF)) };
+				__m128i maxBytes{ _mm_setzero_si128() };
+				for (int py{ startY }; py < endY; ++py)
+				{
+					const uint32_t* pRow{ m_pBackBufferPixels + py * m_RenderWidth };
+					int px{ startX };
+					for (; px + 4 <= endX; px += 4)
+					{
+						const __m128i pixels{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + px)) };
+						minBytes = _mm_min_epu8(minBytes, pixels);
+						maxBytes = _mm_max_epu8(maxBytes, pixels);
+					}
+					for (; px < endX; ++px)
+					{
+						const __m128i pixel{ _mm_cvtsi32_si128(static_cast<int>(pRow[px])) };
+						minBytes = _mm_min_epu8(minBytes, _mm_shuffle_epi32(pixel, 0));
+						maxBytes = _mm_max_epu8(maxBytes, _mm_shuffle_epi32(pixel, 0));
+					}
+				}
+
+				// Fold the four pixel columns together, leaving the per channel spread in the low four bytes
+				minBytes = _mm_min_epu8(minBytes, _mm_srli_si128(minBytes, 8));
+				minBytes = _mm_min_epu8(minBytes, _mm_srli_si128(minBytes, 4));
+				maxBytes = _mm_max_epu8(maxBytes, _mm_srli_si128(maxBytes, 8));
+				maxBytes = _mm_max_epu8(maxBytes, _mm_srli_si128(maxBytes, 4));
+
+				const uint32_t spread{ static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_subs_epu8(maxBytes, minBytes))) };
+				const int contrast{ static_cast<int>(std::max({ spread & 0xFF, (spread >> 8) & 0xFF, (spread >> 16) & 0xFF, spread >> 24 })) };
+
+				m_pTileShadingRates[tileIdx] = static_cast<uint8_t>(contrast < m_Coarse4x4Contrast ? 4 : (contrast < m_Coarse2x2Contrast ? 2 : 1));
+			}
+		}
+	}
+
+	void Renderer::RenderPixel(int px, int py, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		++stats.pixelsTested;
+
+		ColorRGB finalColor{};
+		if(m_ShowOnlyBoundingBoxes)
+		{
+			finalColor = { 1.f, 1.f, 1.f };
+			//Update Color in Buffer
+			m_pBackBufferPixels[px + (py * m_RenderWidth)] = m_pFramebufferWriter->Pack(finalColor);
 			return;
 		}
 
@@ -554,6 +1515,7 @@ namespace dae
 		{
 			return;
 		}
+		++stats.pixelsCovered;
 
 		// Depth
 		const float zDepth{ Utils::Interpolate(v0.position.z, v1.position.z, v2.position.z, weightV0, weightV1, weightV2) };
@@ -565,16 +1527,16 @@ namespace dae
 
 		const float wDepth{ Utils::Interpolate(v0.position.w, v1.position.w, v2.position.w, weightV0, weightV1, weightV2) };
 
-		// Aliases for readablity
-		float& depthBufferElement{ m_pDepthBufferPixels[px + (py * m_Width)] };
-		const bool isCloserToCamera{ zDepth < depthBufferElement };
+		if (m_HeatmapMode == HeatmapMode::depthTests) ++m_pHeatmapCounts[px + (py * m_RenderWidth)];
+
+		// Depth test & write, in whatever format the buffer is in
+		const bool isCloserToCamera{ m_pDepthBuffer->TestAndWrite(px + (py * m_RenderWidth), zDepth, wDepth) };
 
 		if (!isCloserToCamera)
 		{
 			return;
 		}
-
-		depthBufferElement = zDepth;
+		++stats.depthPasses;
 
 		if (m_ShowOnlyDepthBuffer)
 		{
@@ -592,98 +1554,499 @@ namespace dae
 			Vector2 uvInterpolated{ ((v0.uv / v0.position.w) * weightV0 + (v1.uv / v1.position.w) * weightV1 + (v2.uv / v2.position.w) * weightV2) * wDepth };
 			shadingVertex.uv = uvInterpolated;
 
-			Vector3 interpolatedNormal{ ((v0.normal / v0.position.w) * weightV0 + (v1.normal / v1.position.w) * weightV1 + (v2.normal / v2.position.w) * weightV2) * wDepth };
-			interpolatedNormal.Normalize();
-			shadingVertex.normal = interpolatedNormal;
+			if (m_UseTangentSpaceLighting)
+			{
+				Vector3 interpolatedLightDirection{ ((v0.tangentLightDirection / v0.position.w) * weightV0 + (v1.tangentLightDirection / v1.position.w) * weightV1 + (v2.tangentLightDirection / v2.position.w) * weightV2) * wDepth };
+				interpolatedLightDirection.Normalize();
+				shadingVertex.tangentLightDirection = interpolatedLightDirection;
+
+				Vector3 interpolatedViewDirection{ ((v0.tangentViewDirection / v0.position.w) * weightV0 + (v1.tangentViewDirection / v1.position.w) * weightV1 + (v2.tangentViewDirection / v2.position.w) * weightV2) * wDepth };
+				interpolatedViewDirection.Normalize();
+				shadingVertex.tangentViewDirection = interpolatedViewDirection;
+			}
+			else
+			{
+				Vector3 interpolatedViewDirection{ ((v0.viewDirection / v0.position.w) * weightV0 + (v1.viewDirection / v1.position.w) * weightV1 + (v2.viewDirection / v2.position.w) * weightV2) * wDepth };
+				interpolatedViewDirection.Normalize();
+				shadingVertex.viewDirection = interpolatedViewDirection;
+			}
 
-			Vector3 interpolatedTangent{ ((v0.tangent / v0.position.w) * weightV0 + (v1.tangent / v1.position.w) * weightV1 + (v2.tangent / v2.position.w) * weightV2) * wDepth };
-			interpolatedTangent.Normalize();
-			shadingVertex.tangent = interpolatedTangent;
+			// In tangent space the world space frame is only needed to bring lights other than the key light into tangent space
+			if (!m_UseTangentSpaceLighting || HasLightsBesidesKeyLight())
+			{
+				Vector3 interpolatedNormal{ ((v0.normal / v0.position.w) * weightV0 + (v1.normal / v1.position.w) * weightV1 + (v2.normal / v2.position.w) * weightV2) * wDepth };
+				interpolatedNormal.Normalize();
+				shadingVertex.normal = interpolatedNormal;
 
-			Vector3 interpolatedViewDirection{ ((v0.viewDirection / v0.position.w) * weightV0 + (v1.viewDirection / v1.position.w) * weightV1 + (v2.viewDirection / v2.position.w) * weightV2) * wDepth };
-			interpolatedViewDirection.Normalize();
-			shadingVertex.viewDirection = interpolatedViewDirection;
+				Vector3 interpolatedTangent{ ((v0.tangent / v0.position.w) * weightV0 + (v1.tangent / v1.position.w) * weightV1 + (v2.tangent / v2.position.w) * weightV2) * wDepth };
+				interpolatedTangent.Normalize();
+				shadingVertex.tangent = interpolatedTangent;
+			}
 
+			if (m_HasLocalLights)
+			{
+				shadingVertex.worldPosition = ((v0.worldPosition / v0.position.w) * weightV0 + (v1.worldPosition / v1.position.w) * weightV1 + (v2.worldPosition / v2.position.w) * weightV2) * wDepth;
+			}
+
+			if (m_HeatmapMode == HeatmapMode::shadingInvocations) ++m_pHeatmapCounts[px + (py * m_RenderWidth)];
+			++stats.shadedFragments;
+			++stats.textureSamples;
+
+			SampledProfileScope profileScope{ stats.shadingSampleCounter, stats.shadingTicks };
 			finalColor = PixelShading(shadingVertex);
 		}
 
 		//Update Color in Buffer
-		finalColor.MaxToOne();
-
-		m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-			static_cast<uint8_t>(finalColor.r * 255),
-			static_cast<uint8_t>(finalColor.g * 255),
-			static_cast<uint8_t>(finalColor.b * 255));
+		m_pBackBufferPixels[px + (py * m_RenderWidth)] = m_pFramebufferWriter->Pack(finalColor);
 	}
 
 	ColorRGB Renderer::PixelShading(const Vertex_Out& v) const
 	{
-		// Direction light
-		const Vector3 lightDirection{ .577f, -.577f, .577f };
-		constexpr float lightIntensity{ 7.f };
+		// One fetch for diffuse, gloss, normal & specular
+		const MaterialTexel texel{ m_pVehicleMaterial->Sample(v.uv) };
+
+		// Normal & view direction, either both in world space or both in tangent space. Lights follow suit
+		Vector3 normal{};
+		Vector3 viewDirection{};
+		Vector3 binormal{};
+		bool hasBinormal{ false }; // Tangent space only builds it for the first light that isn't the key light
+
+		if (m_UseTangentSpaceLighting)
+		{
+			// The tangent space normal is the sampled one as is, or the unperturbed z-axis
+			normal = m_IsUsingNormalMap ? texel.normal : Vector3::UnitZ;
+			viewDirection = v.tangentViewDirection;
+		}
+		else
+		{
+			normal = v.normal;
+			viewDirection = v.viewDirection;
+
+			if (m_IsUsingNormalMap)
+			{
+				binormal = Vector3::Cross(v.normal, v.tangent);
+				binormal.Normalize();
+				hasBinormal = true;
+
+				const Matrix tangentSpaceAxis = Matrix{ v.tangent, binormal, v.normal, Vector3::Zero };
+
+				normal = tangentSpaceAxis.TransformVector(texel.normal);
+			}
+		}
+
+		const ColorRGB cd = texel.diffuse;
+		const ColorRGB ks = texel.specular;
+		const float exp = texel.gloss;
+		constexpr float pi{ static_cast<float>(M_PI) };
+
+		float totalObservedArea{};
+		ColorRGB totalLambert{};
+		ColorRGB totalPhong{};
+
+		// Only the lights that can reach this pixel's tile
+		int nrOfTileLights{};
+		const uint16_t* pTileLights{ m_pLightCuller->GetTileLights(static_cast<int>(v.position.x), static_cast<int>(v.position.y), nrOfTileLights) };
+
+		for (int tileLightIdx{}; tileLightIdx < nrOfTileLights; ++tileLightIdx)
+		{
+			const int lightIdx{ pTileLights[tileLightIdx] };
+			const Light& light{ m_Lights[lightIdx] };
+
+			Vector3 lightDirection{ light.direction };
+			float attenuation{ 1.f };
+
+			if (light.type != LightType::directional)
+			{
+				lightDirection = v.worldPosition - light.origin;
+				const float distance{ lightDirection.Normalize() };
+				attenuation = light.CalculateAttenuation(lightDirection, distance);
+				if (attenuation <= 0.f) continue;
+			}
+
+			if (m_UseTangentSpaceLighting)
+			{
+				if (lightIdx == m_KeyLightIdx)
+				{
+					lightDirection = v.tangentLightDirection;
+				}
+				else
+				{
+					if (!hasBinormal)
+					{
+						binormal = Vector3::Cross(v.normal, v.tangent);
+						binormal.Normalize();
+						hasBinormal = true;
+					}
+					lightDirection = { Vector3::Dot(lightDirection, v.tangent), Vector3::Dot(lightDirection, binormal), Vector3::Dot(lightDirection, v.normal) };
+				}
+			}
+
+			// Observed area, light direction reversed because of "opposite senses"
+			const float observedArea{ Vector3::Dot(normal, -lightDirection) };
+			if (observedArea <= 0.f) continue;
+
+			const ColorRGB radiance{ light.color * attenuation };
+
+			// Lambert
+			const float kd = light.intensity;
+			const ColorRGB lambert{ kd * cd / pi * radiance };
+
+			// Phong
+			const Vector3 reflect{ lightDirection - 2 * Vector3::Dot(lightDirection, normal) * normal };
+			float cosAlpha{ Vector3::Dot(reflect, -viewDirection) };
+			if (cosAlpha < 0.f)
+			{
+				cosAlpha = 0.f;
+			}
+			const ColorRGB phongSpecularReflection{ ks * m_pSpecularEvaluator->Evaluate(cosAlpha, exp, m_SpecularMode) * radiance };
+
+			totalObservedArea += observedArea * attenuation;
+			totalLambert += lambert * observedArea;
+			totalPhong += phongSpecularReflection * observedArea;
+		}
+
+		switch (m_ShadingMode)
+		{
+		case ShadingMode::observedArea:
+			return { totalObservedArea, totalObservedArea, totalObservedArea };
+
+		case ShadingMode::diffuse:
+			return totalLambert;
+
+		case ShadingMode::specular:
+			return totalPhong;
+
+		case ShadingMode::ENUM_END: // Should not be possible, is in here for warning suppression
+		case ShadingMode::combined:
+			return totalLambert + totalPhong + ColorRGB{ .025f, .025f, .025f };
+		}
+
+		std::cout << "Oh no! Rendering pixel with correct colors failed!\n";
+		return ColorRGB{}; // If this is returned (= completely black), something went wrong. In here for warning suppression
+	}
+
+	void Renderer::RenderQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		QuadWeights weights{};
+		const int mask{ TestQuad(px, py, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, weights, stats) };
+		if (mask == 0)
+		{
+			return;
+		}
+
+		ColorRGBX4 finalColor{};
+		if (m_ShowOnlyDepthBuffer)
+		{
+			const FloatX4 remappedValue{ FloatX4::Clamp((weights.z - .9925f) * (1.f / (1.f - .9925f)), 0.f, 1.f) }; // Same range as the per pixel path
+			finalColor = { remappedValue, remappedValue, remappedValue };
+		}
+		else
+		{
+			const FragmentQuad quad{ InterpolateQuad(px, py, mask, weights, v0, v1, v2) };
+
+			if (m_HeatmapMode == HeatmapMode::shadingInvocations)
+			{
+				const int pixelIndices[4]{ px + py * m_RenderWidth, px + 1 + py * m_RenderWidth, px + (py + 1) * m_RenderWidth, px + 1 + (py + 1) * m_RenderWidth };
+				for (int lane{}; lane < 4; ++lane)
+				{
+					if (mask & (1 << lane)) ++m_pHeatmapCounts[pixelIndices[lane]];
+				}
+			}
+			stats.shadedFragments += std::popcount(static_cast<unsigned>(mask));
+			stats.textureSamples += 4;
+
+			SampledProfileScope profileScope{ stats.shadingSampleCounter, stats.shadingTicks };
+			finalColor = ShadeQuad(quad);
+		}
+
+		//Update Color in Buffer, only the lanes in the mask
+		m_pFramebufferWriter->WriteQuad(m_pBackBufferPixels, m_RenderWidth, px, py, finalColor, mask);
+	}
+
+	int Renderer::TestQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, QuadWeights& weights, RasterizerStats& stats) const
+	{
+		// Lanes: (px, py), (px + 1, py), (px, py + 1), (px + 1, py + 1)
+		const float left{ static_cast<float>(px) };
+		const float top{ static_cast<float>(py) };
+		const FloatX4 pixelX{ left, left + 1.f, left, left + 1.f };
+		const FloatX4 pixelY{ top, top, top + 1.f, top + 1.f };
+
+		// Weight calculations
+		weights.v0 = Utils::CalcWeightX4(v1, v2, pixelX, pixelY, area);
+		weights.v1 = Utils::CalcWeightX4(v2, v0, pixelX, pixelY, area);
+		weights.v2 = Utils::CalcWeightX4(v0, v1, pixelX, pixelY, area);
+
+		// Inside the triangle, and inside the part of the bounding box the per pixel path visits
+		const FloatX4 insideTriangle{ (weights.v0 >= 0.f) & (weights.v1 >= 0.f) & (weights.v2 >= 0.f) };
+		const FloatX4 insideBoundingBox{ (pixelX >= static_cast<float>(boundingBoxMin.x)) & (pixelX < static_cast<float>(boundingBoxMax.x))
+									   & (pixelY >= static_cast<float>(boundingBoxMin.y)) & (pixelY < static_cast<float>(boundingBoxMax.y)) };
+		int mask{ (insideTriangle & insideBoundingBox).MoveMask() };
+		stats.pixelsTested += std::popcount(static_cast<unsigned>(insideBoundingBox.MoveMask()));
+		if (mask == 0)
+		{
+			return 0;
+		}
+		stats.pixelsCovered += std::popcount(static_cast<unsigned>(mask));
+
+		// Depth
+		weights.z = Utils::InterpolateX4(v0.position.z, v1.position.z, v2.position.z, weights.v0, weights.v1, weights.v2);
+		// Z Frustrum culling
+		mask &= ((weights.z >= 0.f) & (weights.z <= 1.f)).MoveMask();
+
+		weights.w = Utils::InterpolateX4(v0.position.w, v1.position.w, v2.position.w, weights.v0, weights.v1, weights.v2);
+
+		// Depth test lane by lane, failing lanes drop out of the mask
+		alignas(16) float zLanes[4];
+		alignas(16) float wLanes[4];
+		weights.z.Store(zLanes);
+		weights.w.Store(wLanes);
+		const int pixelIndices[4]{ px + py * m_RenderWidth, px + 1 + py * m_RenderWidth, px + (py + 1) * m_RenderWidth, px + 1 + (py + 1) * m_RenderWidth };
+		for (int lane{}; lane < 4; ++lane)
+		{
+			if (!(mask & (1 << lane))) continue;
+
+			if (m_HeatmapMode == HeatmapMode::depthTests) ++m_pHeatmapCounts[pixelIndices[lane]];
+			if (!m_pDepthBuffer->TestAndWrite(pixelIndices[lane], zLanes[lane], wLanes[lane])) mask &= ~(1 << lane);
+		}
+
+		stats.depthPasses += std::popcount(static_cast<unsigned>(mask));
+		return mask;
+	}
+
+	FragmentQuad Renderer::InterpolateQuad(int px, int py, int mask, const QuadWeights& weights, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2) const
+	{
+		// Perspective correct weights, shared by every attribute
+		const FloatX4 perspectiveWeightV0{ weights.v0 / v0.position.w * weights.w };
+		const FloatX4 perspectiveWeightV1{ weights.v1 / v1.position.w * weights.w };
+		const FloatX4 perspectiveWeightV2{ weights.v2 / v2.position.w * weights.w };
+
+		FragmentQuad quad{};
+		quad.x = px;
+		quad.y = py;
+		quad.mask = mask;
+		quad.depth = weights.z;
+		quad.u = perspectiveWeightV0 * v0.uv.x + perspectiveWeightV1 * v1.uv.x + perspectiveWeightV2 * v2.uv.x;
+		quad.v = perspectiveWeightV0 * v0.uv.y + perspectiveWeightV1 * v1.uv.y + perspectiveWeightV2 * v2.uv.y;
+
+		if (m_UseTangentSpaceLighting)
+		{
+			quad.tangentLightDirection = Utils::InterpolateAttributeX4(v0.tangentLightDirection, v1.tangentLightDirection, v2.tangentLightDirection, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+			quad.tangentLightDirection.Normalize();
+			quad.tangentViewDirection = Utils::InterpolateAttributeX4(v0.tangentViewDirection, v1.tangentViewDirection, v2.tangentViewDirection, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+			quad.tangentViewDirection.Normalize();
+		}
+		else
+		{
+			quad.viewDirection = Utils::InterpolateAttributeX4(v0.viewDirection, v1.viewDirection, v2.viewDirection, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+			quad.viewDirection.Normalize();
+		}
+
+		// Same rule as the per pixel path
+		if (!m_UseTangentSpaceLighting || HasLightsBesidesKeyLight())
+		{
+			quad.normal = Utils::InterpolateAttributeX4(v0.normal, v1.normal, v2.normal, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+			quad.normal.Normalize();
+			quad.tangent = Utils::InterpolateAttributeX4(v0.tangent, v1.tangent, v2.tangent, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+			quad.tangent.Normalize();
+		}
+
+		if (m_HasLocalLights)
+		{
+			quad.worldPosition = Utils::InterpolateAttributeX4(v0.worldPosition, v1.worldPosition, v2.worldPosition, perspectiveWeightV0, perspectiveWeightV1, perspectiveWeightV2);
+		}
+
+		return quad;
+	}
+
+	void Renderer::RenderCoarseBlock(int px, int py, int rate, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const
+	{
+		// Block of 2x2 coarse pixels, each rate x rate pixels. Coverage & depth per pixel like always, quad by quad
+		int quadMasks[m_MaxShadingRate * m_MaxShadingRate]{};
+		int coarseMask{};
+		for (int quadY{}; quadY < rate; ++quadY)
+		{
+			for (int quadX{}; quadX < rate; ++quadX)
+			{
+				QuadWeights weights{};
+				const int mask{ TestQuad(px + 2 * quadX, py + 2 * quadY, boundingBoxMin, boundingBoxMax, v0, v1, v2, area, weights, stats) };
+				quadMasks[quadX + quadY * rate] = mask;
+
+				// Lane of the coarse pixel the quad lies in
+				if (mask != 0) coarseMask |= 1 << (2 * quadX / rate + 2 * (2 * quadY / rate));
+			}
+		}
+
+		if (coarseMask == 0)
+		{
+			return;
+		}
+
+		// One fragment per coarse pixel, at its center. Pulled onto the triangle, so the attributes never get extrapolated past its edges
+		const float centerOffset{ .5f * static_cast<float>(rate - 1) };
+		const float left{ static_cast<float>(px) + centerOffset };
+		const float top{ static_cast<float>(py) + centerOffset };
+		const float coarseSize{ static_cast<float>(rate) };
+		const FloatX4 centerX{ left, left + coarseSize, left, left + coarseSize };
+		const FloatX4 centerY{ top, top, top + coarseSize, top + coarseSize };
+
+		// The block lies inside one light tile, like a quad
+		const FragmentQuad quad{ InterpolateQuad(px, py, coarseMask, CalculateClampedWeights(centerX, centerY, v0, v1, v2, area), v0, v1, v2) };
+		stats.shadedFragments += std::popcount(static_cast<unsigned>(coarseMask));
+		stats.textureSamples += 4;
+
+		ColorRGBX4 coarseColor{};
+		{
+			SampledProfileScope profileScope{ stats.shadingSampleCounter, stats.shadingTicks };
+			coarseColor = ShadeQuad(quad);
+		}
 
-		Vector3 normal{ v.normal };
+		alignas(16) float red[4];
+		alignas(16) float green[4];
+		alignas(16) float blue[4];
+		coarseColor.r.Store(red);
+		coarseColor.g.Store(green);
+		coarseColor.b.Store(blue);
 
-		if (m_IsUsingNormalMap)
+		// Every quad gets its coarse pixel's color, only on the lanes that passed
+		int countedMask{};
+		for (int quadY{}; quadY < rate; ++quadY)
 		{
-			Vector3 binormal(Vector3::Cross(v.normal, v.tangent));
-			binormal.Normalize();
+			for (int quadX{}; quadX < rate; ++quadX)
+			{
+				const int mask{ quadMasks[quadX + quadY * rate] };
+				if (mask == 0) continue;
+
+				const int qx{ px + 2 * quadX };
+				const int qy{ py + 2 * quadY };
+				const int lane{ 2 * quadX / rate + 2 * (2 * quadY / rate) };
 
-			const Matrix tangentSpaceAxis = Matrix{ v.tangent, binormal, v.normal, Vector3::Zero };
+				// One invocation per coarse pixel, counted on the first pixel it got written to
+				if (m_HeatmapMode == HeatmapMode::shadingInvocations && !(countedMask & (1 << lane)))
+				{
+					const int firstLane{ std::countr_zero(static_cast<unsigned>(mask)) };
+					++m_pHeatmapCounts[qx + (firstLane & 1) + (qy + (firstLane >> 1)) * m_RenderWidth];
+					countedMask |= 1 << lane;
+				}
 
-			const ColorRGB sampledNormalRGB = m_pVehicleNormal->Sample(v.uv);
-			normal =
-			{ 2 * sampledNormalRGB.r - 1.f,
-			  2 * sampledNormalRGB.g - 1.f,
-			  2 * sampledNormalRGB.b - 1.f
-			};
-			normal = tangentSpaceAxis.TransformVector(normal);
+				const ColorRGBX4 laneColor{ FloatX4{ red[lane] }, FloatX4{ green[lane] }, FloatX4{ blue[lane] } };
+				m_pFramebufferWriter->WriteQuad(m_pBackBufferPixels, m_RenderWidth, qx, qy, laneColor, mask);
+			}
 		}
+	}
+
+	ColorRGBX4 Renderer::ShadeQuad(const FragmentQuad& quad) const
+	{
+		// Four fetches for diffuse, gloss, normal & specular, transposed into lanes
+		const MaterialTexelX4 texel{ m_pVehicleMaterial->SampleX4(quad.u, quad.v, quad.mask) };
 
-		float observedArea{ Vector3::Dot(normal, -lightDirection) };
+		// Same structure as PixelShading, see there
+		Vector3X4 normal{};
+		Vector3X4 viewDirection{};
+		Vector3X4 binormal{};
+		bool hasBinormal{ false };
 
-		// Observed area, light direction reversed because of "opposite senses"
-		if (observedArea < 0.f)
+		if (m_UseTangentSpaceLighting)
 		{
-			observedArea = 0.f;
+			normal = m_IsUsingNormalMap ? texel.normal : Vector3X4{ Vector3::UnitZ };
+			viewDirection = quad.tangentViewDirection;
+		}
+		else
+		{
+			normal = quad.normal;
+			viewDirection = quad.viewDirection;
+
+			if (m_IsUsingNormalMap)
+			{
+				binormal = Vector3X4::Cross(quad.normal, quad.tangent);
+				binormal.Normalize();
+				hasBinormal = true;
+
+				// Rows of the tangent frame, like Matrix::TransformVector
+				normal = quad.tangent * texel.normal.x + binormal * texel.normal.y + quad.normal * texel.normal.z;
+			}
 		}
 
-		// Lambert
-		constexpr float kd = lightIntensity;
-		const ColorRGB cd = m_pVehicleDiffuse->Sample(v.uv);
 		constexpr float pi{ static_cast<float>(M_PI) };
-		const ColorRGB lambert{ kd * cd / pi };
 
-		// Phong
-		const Vector3 reflect{ lightDirection - 2 * Vector3::Dot(lightDirection, normal) * normal };
-		float cosAlpha{ Vector3::Dot(reflect, -v.viewDirection) };
-		if (cosAlpha < 0.f)
+		FloatX4 totalObservedArea{};
+		ColorRGBX4 totalLambert{};
+		ColorRGBX4 totalPhong{};
+
+		// A quad never straddles a tile, so all four lanes share the light list
+		int nrOfTileLights{};
+		const uint16_t* pTileLights{ m_pLightCuller->GetTileLights(quad.x, quad.y, nrOfTileLights) };
+
+		for (int tileLightIdx{}; tileLightIdx < nrOfTileLights; ++tileLightIdx)
 		{
-			cosAlpha = 0.f;
+			const int lightIdx{ pTileLights[tileLightIdx] };
+			const Light& light{ m_Lights[lightIdx] };
+
+			Vector3X4 lightDirection{ light.direction };
+			FloatX4 attenuation{ 1.f };
+
+			if (light.type != LightType::directional)
+			{
+				lightDirection = quad.worldPosition - Vector3X4{ light.origin };
+				const FloatX4 distance{ lightDirection.Normalize() };
+				attenuation = light.CalculateAttenuationX4(lightDirection, distance);
+			}
+
+			if (m_UseTangentSpaceLighting)
+			{
+				if (lightIdx == m_KeyLightIdx)
+				{
+					lightDirection = quad.tangentLightDirection;
+				}
+				else
+				{
+					if (!hasBinormal)
+					{
+						binormal = Vector3X4::Cross(quad.normal, quad.tangent);
+						binormal.Normalize();
+						hasBinormal = true;
+					}
+					lightDirection = { Vector3X4::Dot(lightDirection, quad.tangent), Vector3X4::Dot(lightDirection, binormal), Vector3X4::Dot(lightDirection, quad.normal) };
+				}
+			}
+
+			// Observed area, light direction reversed because of "opposite senses". Unlit lanes contribute nothing
+			const FloatX4 observedArea{ Vector3X4::Dot(normal, -lightDirection) };
+			const FloatX4 isLit{ (observedArea > 0.f) & (attenuation > 0.f) };
+			if (isLit.MoveMask() == 0) continue;
+
+			const FloatX4 litObservedArea{ FloatX4::Mask(isLit, observedArea) };
+			const ColorRGBX4 radiance{ ColorRGBX4{ light.color } * attenuation };
+
+			// Lambert
+			const ColorRGBX4 lambert{ texel.diffuse * (light.intensity / pi) * radiance };
+
+			// Phong, max also turns NaN from lanes outside the mask into 0
+			const Vector3X4 reflect{ lightDirection - normal * (Vector3X4::Dot(lightDirection, normal) * 2.f) };
+			const FloatX4 cosAlpha{ FloatX4::Max(Vector3X4::Dot(reflect, -viewDirection), 0.f) };
+			const ColorRGBX4 phongSpecularReflection{ texel.specular * m_pSpecularEvaluator->EvaluateX4(cosAlpha, texel.gloss, m_SpecularMode) * radiance };
+
+			totalObservedArea += litObservedArea * attenuation;
+			totalLambert += lambert * litObservedArea;
+			totalPhong += phongSpecularReflection * litObservedArea;
 		}
-		const ColorRGB ks = m_pVehicleSpecular->Sample(v.uv);
-		const float exp = m_pVehicleGloss->Sample(v.uv).r;
-		constexpr float shininess{ 25.f };
-		ColorRGB phongSpecularReflection{ ks * powf(cosAlpha, exp * shininess) };
 
 		switch (m_ShadingMode)
 		{
 		case ShadingMode::observedArea:
-			return { observedArea, observedArea, observedArea };
+			return { totalObservedArea, totalObservedArea, totalObservedArea };
 
 		case ShadingMode::diffuse:
-			return lambert * observedArea;
+			return totalLambert;
 
 		case ShadingMode::specular:
-			return phongSpecularReflection * observedArea;
+			return totalPhong;
 
 		case ShadingMode::ENUM_END: // Should not be possible, is in here for warning suppression
 		case ShadingMode::combined:
-			return (lambert + phongSpecularReflection) * observedArea + ColorRGB{ .025f, .025f, .025f };
+			return totalLambert + totalPhong + ColorRGBX4{ ColorRGB{ .025f, .025f, .025f } };
 		}
 
-		std::cout << "Oh no! Rendering pixel with correct colors failed!\n";
-		return ColorRGB{}; // If this is returned (= completely black), something went wrong. In here for warning suppression
+		return ColorRGBX4{}; // Warning suppression, see PixelShading
 	}
 
 	void Renderer::ToggleShowDepthBuffer()
@@ -699,5 +2062,260 @@ namespace dae
 		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
 		std::cout << "**(SOFTWARE) BoundingBox Visualization " << (m_ShowOnlyBoundingBoxes ? "ON" : "OFF") << std::endl;
 	}
+
+	void Renderer::ToggleTangentSpaceLighting()
+	{
+		m_UseTangentSpaceLighting = !m_UseTangentSpaceLighting;
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Lighting Space = " << (m_UseTangentSpaceLighting ? "TANGENT (PER VERTEX)" : "WORLD") << std::endl;
+	}
+
+	void Renderer::ToggleSimdShading()
+	{
+		m_UseSimdShading = !m_UseSimdShading;
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Shading Path = " << (m_UseSimdShading ? "SIMD QUADS" : "SCALAR") << std::endl;
+	}
+
+	void Renderer::ToggleAsyncPresent()
+	{
+		if (m_IsHeadless) return; // Nothing to present to
+
+		// Synchronous frames write the window surface directly, so nothing may still be in flight
+		m_pPresenter->Flush();
+		m_UseAsyncPresent = !m_UseAsyncPresent;
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Present = ";
+		if (m_UseAsyncPresent)					std::cout << "ASYNC (present thread, double buffered)" << std::endl;
+		else if (m_IsRenderingIntoFrontBuffer)	std::cout << "ZERO-COPY (window surface)" << std::endl;
+		else									std::cout << "BLIT (window surface format differs)" << std::endl;
+	}
+
+	void Renderer::CycleDepthFormat()
+	{
+		// Cycling, the targets pick the new format up at the start of the next frame and clear on first touch as always
+		m_DepthFormat = static_cast<DepthFormat>(static_cast<int>(m_DepthFormat) + 1);
+		if (m_DepthFormat == DepthFormat::ENUM_END)
+		{
+			m_DepthFormat = static_cast<DepthFormat>(0);
+		}
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Depth Format = " << DepthBuffer::GetFormatName(m_DepthFormat) << std::endl;
+	}
+
+	void Renderer::CycleHeatmapMode()
+	{
+		// Cycling
+		m_HeatmapMode = static_cast<HeatmapMode>(static_cast<int>(m_HeatmapMode) + 1);
+		if (m_HeatmapMode == HeatmapMode::ENUM_END)
+		{
+			m_HeatmapMode = static_cast<HeatmapMode>(0);
+		}
+
+		// Console logging:
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Heatmap = ";
+		switch (m_HeatmapMode)
+		{
+		case HeatmapMode::off:
+			std::cout << "OFF\n";
+			break;
+		case HeatmapMode::depthTests:
+			std::cout << "DEPTH TESTS (red = 8+ per pixel)\n";
+			break;
+		case HeatmapMode::shadingInvocations:
+			std::cout << "SHADING INVOCATIONS (red = 8+ per pixel)\n";
+			break;
+		case HeatmapMode::tileTime:
+			std::cout << "TILE RASTERIZATION TIME (red = slowest tile)\n";
+			break;
+		case HeatmapMode::ENUM_END:
+			break;
+		}
+	}
+
+	void Renderer::PrintFrameProfile() const
+	{
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		m_pProfiler->PrintPercentiles();
+	}
+
+	void Renderer::ToggleTraceRecording()
+	{
+		TraceRecorder* pTraceRecorder{ TraceRecorder::GetInstance() };
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_YELLOW);
+
+		if (!pTraceRecorder->IsEnabled())
+		{
+			pTraceRecorder->SetEnabled(true);
+			std::cout << "**(SHARED) Trace Recording ON\n";
+			return;
+		}
+
+		// The present thread has to be idle before its ring gets read
+		pTraceRecorder->SetEnabled(false);
+		if (m_pPresenter) m_pPresenter->Flush();
+
+		const bool isWritten{ pTraceRecorder->WriteJson("Trace.json") };
+		std::cout << "**(SHARED) Trace Recording OFF" << (isWritten ? ", written to Trace.json (open in chrome://tracing or ui.perfetto.dev)" : ", writing Trace.json failed") << std::endl;
+	}
+
+	void Renderer::SetWorkerCount(int nrOfWorkers)
+	{
+		// Benchmarks set it every run, don't respawn the threads for nothing
+		if (m_pWorkerPool && m_pWorkerPool->GetNrOfWorkers() == std::max(nrOfWorkers, 1)) return;
+
+		SAFE_DELETE(m_pWorkerPool)
+		m_pWorkerPool = new WorkerPool{ nrOfWorkers };
+		m_ThreadStats.resize(m_pWorkerPool->GetNrOfWorkers());
+	}
+
+	int Renderer::GetWorkerCount() const
+	{
+		return m_pWorkerPool->GetNrOfWorkers();
+	}
+
+	void Renderer::CycleWorkerCount()
+	{
+		// Powers of two, then every hardware thread, then back to one
+		const int nrOfHardwareThreads{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) };
+		const int nrOfWorkers{ GetWorkerCount() };
+		SetWorkerCount(nrOfWorkers >= nrOfHardwareThreads ? 1 : std::min(nrOfWorkers * 2, nrOfHardwareThreads));
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Raster Workers = " << GetWorkerCount() << std::endl;
+	}
+
+	void Renderer::CycleShadingRate()
+	{
+		// Cycling
+		SetShadingRate(static_cast<ShadingRate>((static_cast<int>(m_ShadingRate) + 1) % static_cast<int>(ShadingRate::ENUM_END)));
+
+		// Console logging:
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Shading Rate = ";
+		switch (m_ShadingRate)
+		{
+		case ShadingRate::full:
+			std::cout << "FULL\n";
+			break;
+		case ShadingRate::coarse2x2:
+			std::cout << "COARSE 2X2\n";
+			break;
+		case ShadingRate::coarse4x4:
+			std::cout << "COARSE 4X4\n";
+			break;
+		case ShadingRate::adaptive:
+			std::cout << "ADAPTIVE (per tile, from last frame's contrast)\n";
+			break;
+		case ShadingRate::ENUM_END:
+			break;
+		}
+	}
+
+	void Renderer::SetShadingRate(ShadingRate shadingRate)
+	{
+		// Adaptive starts out at full rate, until a frame got measured
+		if (shadingRate == ShadingRate::adaptive && m_ShadingRate != ShadingRate::adaptive)
+		{
+			std::fill_n(m_pTileShadingRates, m_SyncTarget.nrOfTilesX * m_SyncTarget.nrOfTilesY, static_cast<uint8_t>(1));
+		}
+		m_ShadingRate = shadingRate;
+	}
+
+	void Renderer::ToggleMsaa()
+	{
+		SetMsaa(!m_UseMsaa);
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) MSAA " << (m_UseMsaa ? "4X (shaded once per pixel, resolve shows up as MSAA_RESOLVE in the frame profile, the extra sample tests as RASTERIZATION)" : "OFF") << std::endl;
+	}
+
+	void Renderer::SetMsaa(bool useMsaa)
+	{
+		// Sample buffers only exist once MSAA got turned on, first touch clears them like any tile
+		m_UseMsaa = useMsaa;
+		if (m_UseMsaa) AllocateMsaaTargets();
+	}
+
+	void Renderer::ToggleFxaa()
+	{
+		SetFxaa(!m_UseFxaa);
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) FXAA " << (m_UseFxaa ? "ON (cost shows up as ANTI_ALIASING in the frame profile)" : "OFF") << std::endl;
+	}
+
+	void Renderer::ToggleDynamicResolution()
+	{
+		SetDynamicResolution(m_UseDynamicResolution ? 0.f : m_pDynamicResolution->GetSettings().targetMs);
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Dynamic Resolution " << (m_UseDynamicResolution ? "ON" : "OFF")
+			<< " (target " << m_pDynamicResolution->GetSettings().targetMs << " ms)" << std::endl;
+	}
+
+	void Renderer::SetDynamicResolution(float targetMs)
+	{
+		m_UseDynamicResolution = targetMs > 0.f;
+		if (m_UseDynamicResolution)
+		{
+			// Starts from wherever the scale is now
+			m_pDynamicResolution->SetTargetMs(targetMs);
+			m_pDynamicResolution->Reset(m_RenderScale);
+		}
+		else
+		{
+			SetRenderScale(1.f);
+		}
+	}
+
+	void Renderer::PrintRasterizerStats() const
+	{
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Rasterizer Stats, last frame\n"
+			<< "	Triangles submitted:	" << m_FrameStats.trianglesSubmitted << '\n'
+			<< "	Frustum rejected:	" << m_FrameStats.frustumRejected << '\n'
+			<< "	Zero area:		" << m_FrameStats.zeroArea << '\n'
+			<< "	Culled (cull mode):	" << m_FrameStats.backfaceCulled << '\n'
+			<< "	Pixels tested:		" << m_FrameStats.pixelsTested << '\n'
+			<< "	Pixels covered:		" << m_FrameStats.pixelsCovered << '\n'
+			<< "	Depth passes:		" << m_FrameStats.depthPasses << '\n'
+			<< "	Shaded fragments:	" << m_FrameStats.shadedFragments << '\n'
+			<< "	Texture samples:	" << m_FrameStats.textureSamples << std::endl;
+	}
+
+	bool Renderer::WriteFrameProfile(const std::string& filePath) const
+	{
+		return m_pProfiler->WriteCsv(filePath);
+	}
+
+	void Renderer::CycleSpecularMode()
+	{
+		m_SpecularMode = static_cast<SpecularMode>(static_cast<int>(m_SpecularMode) + 1);
+		if (m_SpecularMode == SpecularMode::ENUM_END)
+		{
+			m_SpecularMode = static_cast<SpecularMode>(0);
+		}
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Specular = ";
+		switch (m_SpecularMode)
+		{
+		case SpecularMode::exact:
+			std::cout << "EXACT";
+			break;
+		case SpecularMode::lookupTable:
+			std::cout << "LOOKUP_TABLE";
+			break;
+		case SpecularMode::ENUM_END: // Impossible; in here for warning suppression
+		case SpecularMode::approximation:
+			std::cout << "APPROXIMATION";
+			break;
+		}
+		std::cout << " (max error " << m_pSpecularEvaluator->GetMaxError(m_SpecularMode) << ")" << std::endl;
+	}
 #pragma endregion
 }
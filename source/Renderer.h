@@ -2,6 +2,9 @@
 #include <unordered_map>
 
 #include "Structs.h"
+#include "Light.h"
+#include "SoftwarePresenter.h"
+#include "RasterizerStats.h"
 
 struct SDL_Window;
 struct SDL_Surface;
@@ -12,7 +15,19 @@ namespace dae
 	class Mesh;
 	struct Camera;
 	class Texture;
+	class MaterialBundle;
+	class SpecularEvaluator;
+	class TiledLightCuller;
+	class FramebufferWriter;
+	class DepthBuffer;
+	class FrameProfiler;
+	class WorkerPool;
+	class Upscaler;
+	class DynamicResolution;
+	class FxaaPass;
 	enum class EffectType;
+	enum class SpecularMode;
+	enum class DepthFormat;
 
 	enum class ShadingMode
 	{
@@ -39,10 +54,35 @@ namespace dae
 		ENUM_END
 	};
 
+	// Software debug views, drawn over the finished frame
+	enum class HeatmapMode
+	{
+		off,
+		depthTests,
+		shadingInvocations,
+		tileTime,
+		ENUM_END
+	};
+
+	// Software shading rate, coverage & depth stay per pixel at every rate
+	enum class ShadingRate
+	{
+		full,
+		coarse2x2,	// One shading invocation per 2x2 pixels
+		coarse4x4,
+		adaptive,	// Per clear tile, picked from the color contrast the tile had last frame
+		ENUM_END
+	};
+
 	class Renderer final
 	{
+		// Times PixelShading on its own
+		friend class KernelBenchmarks;
+
 	public:
 		Renderer(SDL_Window* pWindow);
+		// Headless: software rasterizer only, into an offscreen target. No window, no DirectX
+		Renderer(int width, int height);
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -51,7 +91,8 @@ namespace dae
 		Renderer& operator=(Renderer&&) noexcept = delete;
 
 		void Update(const Timer* pTimer);
-		void Render() const;
+		void Update(float deltaTime);
+		void Render();
 
 		template<typename T_Vertex>
 		Mesh<T_Vertex>* GetMesh() const;
@@ -71,17 +112,79 @@ namespace dae
 		// bool SaveBufferToImage() const;
 		void ToggleShowDepthBuffer();
 		void ToggleShowBoundingBoxes();
+		void CycleSpecularMode();
+		void ToggleTangentSpaceLighting();
+		void ToggleLightShowcase();
+		void ToggleSimdShading();
+		void ToggleAsyncPresent();
+		void CycleDepthFormat();
+		void CycleHeatmapMode();
+		void PrintFrameProfile() const;
+		void ToggleTraceRecording();
+		void PrintRasterizerStats() const;
+		void CycleWorkerCount();
+		void ToggleDynamicResolution();
+		void CycleShadingRate();
+		void ToggleMsaa();
+		void ToggleFxaa();
+
+		// Finished software frame, the pitch is in bytes. Only stable after Render returns, and not while async present is on
+		// The frame is at the render size, which is below the output size while the render scale is under 1
+		const uint32_t* GetFramePixels() const { return m_SyncTarget.pColorPixels; }
+		int GetFramePitch() const { return m_SyncTarget.pColor->pitch; }
+		const SDL_PixelFormat* GetFrameFormat() const { return m_SyncTarget.pColor->format; }
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		int GetRenderWidth() const { return m_RenderWidth; }
+		int GetRenderHeight() const { return m_RenderHeight; }
+		bool IsHeadless() const { return m_IsHeadless; }
+		void SetCameraPose(const Vector3& origin, float pitch, float yaw);
+		// Reallocates every target at the new size & follows with the camera's aspect ratio, call between frames
+		void Resize(int width, int height);
+		// Software path only, renders at scale * output size & upscales at present
+		void SetRenderScale(float renderScale);
+		float GetRenderScale() const { return m_RenderScale; }
+		// Adjusts the render scale to hold the frame time, 0 turns it off & goes back to full size
+		void SetDynamicResolution(float targetMs);
+		// Takes ownership, the software path rasterizes it instead of the vehicle (still with the vehicle's material). nullptr goes back
+		void SetStressMesh(Mesh<Vertex_PosTex>* pMesh);
+
+		// Same as the cycles & toggles, without the console logging, for scripted runs
+		void SetShadingMode(ShadingMode shadingMode);
+		void SetCullingMode(CullingMode cullingMode);
+		void SetSimdShading(bool useSimdShading) { m_UseSimdShading = useSimdShading; }
+		void SetShadingRate(ShadingRate shadingRate);
+		void SetMsaa(bool useMsaa);
+		void SetFxaa(bool useFxaa) { m_UseFxaa = useFxaa; }
+		void SetWorkerCount(int nrOfWorkers);
+		int GetWorkerCount() const;
+		const RasterizerStats& GetRasterizerStats() const { return m_FrameStats; }
+		const FrameProfiler* GetFrameProfiler() const { return m_pProfiler; }
+		bool WriteFrameProfile(const std::string& filePath) const;
+
+		void AddLight(const Light& light);
+		void ClearLights();
+		const std::vector<Light>& GetLights() const;
 
 	private:
 		// DUAL RASTERIZER
 		const ColorRGB m_UniformClearColor{ .1f, .1f, .1f };
 
+		// The key light is the first directional light: used by the hardware rasterizer & per vertex tangent space lighting
+		std::vector<Light> m_Lights{};
+		int m_KeyLightIdx{ -1 };	// -1 while there's no directional light
+		bool m_HasLocalLights{ false };
+		bool m_IsShowingLightShowcase{ false };
+
 		SDL_Window* m_pWindow{};
 
 		int m_Width{};
 		int m_Height{};
+		int m_RenderWidth{};	// Software rasterizer's own size, m_Width * m_RenderScale
+		int m_RenderHeight{};
 
 		bool m_IsInitialized{ false };
+		bool m_IsHeadless{ false };
 		bool m_IsMeshRotating{ true };
 		bool m_UseSoftwareRasterizer{ false };
 		bool m_UseUniformColor{ false };
@@ -94,7 +197,7 @@ namespace dae
 		Texture* m_pVehicleSpecular;
 		Texture* m_pVehicleNormal;
 
-		Mesh<Vertex_PosTex>* m_pMesh;
+		Mesh<Vertex_PosTex>* m_pMesh{};	// Generated stress mesh, replaces the vehicle in the software path when set
 		Mesh<Vertex_PosTex>* m_pVehicle;
 		Mesh<Vertex_PosTex>* m_pFireEffect;
 		Camera* m_pCamera;
@@ -106,25 +209,33 @@ namespace dae
 
 		FilteringMode m_FilteringMode{ FilteringMode::anisotropic };
 
-		ID3D11Device* m_pDevice{};
+		ID3D11Device* m_pDevice{};	// Stays nullptr headless & in DISABLE_DIRECTX builds, textures & meshes then skip their GPU side
+#ifndef DISABLE_DIRECTX
 		ID3D11DeviceContext* m_pDeviceContext{};
 		IDXGISwapChain* m_pSwapChain{};
 		ID3D11Texture2D* m_pDepthStencilBuffer{};
 		ID3D11DepthStencilView* m_pDepthStencilView{};
 		ID3D11Resource* m_pRenderTargetBuffer{};
 		ID3D11RenderTargetView* m_pRenderTargetView{};
+#endif
 		
 		Texture* m_pFireDiffuse;
 
+#ifndef DISABLE_DIRECTX
 		// DirectX
 		HRESULT InitializeDirectX();
 		HRESULT InitializeDeviceAndDeviceContext();
 		HRESULT InitializeSwapChain(IDXGIFactory* pIdxgiFactory);
 		HRESULT InitializeDepthStencil();
 		HRESULT InitializeDepthStencilView();
+		// Depth stencil, render target view & viewport, at the current size
+		HRESULT InitializeRenderTargets();
+		HRESULT ResizeDirectXTargets();
 		void SetViewport();
 
 		void ReleaseDirectXResources();
+#endif
+		void UpdateHardwareKeyLight();
 
 		void HardwareRender() const;
 
@@ -133,10 +244,33 @@ namespace dae
 		const ColorRGB m_SoftwareClearColor{ .39f, .39f, .39f };
 
 		SDL_Surface* m_pFrontBuffer{ nullptr };
+
+		// Target the current frame gets rasterized into, either the synchronous one or one of the presenter's
 		SDL_Surface* m_pBackBuffer{ nullptr };
 		uint32_t* m_pBackBufferPixels{};
+		DepthBuffer* m_pDepthBuffer{};
+
+		RenderTarget m_SyncTarget{};	// Color is the front buffer itself when rendering zero-copy
+		bool m_IsRenderingIntoFrontBuffer{ false };
+		SoftwarePresenter* m_pPresenter{};
+		bool m_UseAsyncPresent{ false };
+
+		RenderTarget m_BoundTarget{};
+		uint32_t m_FrameEpoch{};
+		uint32_t m_PackedClearColor{};
+
+		MaterialBundle* m_pVehicleMaterial{};
+		SpecularEvaluator* m_pSpecularEvaluator{};
+		TiledLightCuller* m_pLightCuller{};
+		FramebufferWriter* m_pFramebufferWriter{};
+		Upscaler* m_pUpscaler{};
+
+		float m_RenderScale{ 1.f };
+		bool m_UseDynamicResolution{ false };
+		DynamicResolution* m_pDynamicResolution{};
 
-		float* m_pDepthBufferPixels{};
+		SpecularMode m_SpecularMode;
+		DepthFormat m_DepthFormat;
 
 		int m_NrOfPixels{};
 		float m_AspectRatio{};
@@ -144,15 +278,119 @@ namespace dae
 		bool m_IsUsingNormalMap{ true };
 		bool m_ShowOnlyDepthBuffer{ false };
 		bool m_ShowOnlyBoundingBoxes{ false };
-
+		bool m_UseTangentSpaceLighting{ false };
+		bool m_UseSimdShading{ false };
+
+		HeatmapMode m_HeatmapMode{ HeatmapMode::off };
+		uint32_t* m_pHeatmapCounts{};		// Per pixel, depth tests or shading invocations
+		uint64_t* m_pHeatmapTileTimes{};	// Per clear tile, performance counter ticks spent rasterizing
+		// Adaptive shading rate per clear tile (1, 2 or 4), spread of any channel below the thresholds goes coarse
+		ShadingRate m_ShadingRate{ ShadingRate::full };
+		uint8_t* m_pTileShadingRates{};
+		static constexpr int m_MaxShadingRate{ 4 };
+		static constexpr int m_Coarse4x4Contrast{ 12 };
+		static constexpr int m_Coarse2x2Contrast{ 40 };
+
+		// 4x MSAA: coverage & depth per sample, shading once per pixel per triangle, resolved per bin
+		static constexpr int m_NrOfSamples{ 4 };
+		bool m_UseMsaa{ false };
+		DepthBuffer* m_pSampleDepth{};
+		uint32_t* m_pSampleColors{};	// Packed like the back buffer, a pixel's samples side by side
+		int m_SampleCapacity{};
+
+		// Post process AA over the finished back buffer, before the heatmap overlay
+		bool m_UseFxaa{ false };
+		FxaaPass* m_pFxaaPass{};
+
+		int m_PixelCapacity{};				// Allocated sizes of the per pixel & per tile arrays, kept across resizes
+		int m_TileCapacity{};
+
+		FrameProfiler* m_pProfiler{};
+
+		std::vector<RasterizerStats> m_ThreadStats{ 1 };	// One slot per rasterizing thread, the main thread is slot 0
+		RasterizerStats m_FrameStats{};						// Merged slots of the last software frame
+
+		// Triangles get set up once on the main thread, then binned into screen bins that the workers rasterize independently
+		struct SetupTriangle
+		{
+			Vertex_Out v0;
+			Vertex_Out v1;
+			Vertex_Out v2;
+			float area;
+			Pixel2D boundingBoxMin;
+			Pixel2D boundingBoxMax;
+		};
+
+		static constexpr int m_BinSize{ 64 };	// Multiple of the clear tile size, so no tile or quad is shared by two bins
+		WorkerPool* m_pWorkerPool{};
+		std::vector<SetupTriangle> m_SetupTriangles{};
+		std::vector<std::vector<uint32_t>> m_BinTriangles{};	// Indices into m_SetupTriangles, in submission order
+		int m_NrOfBinsX{};
+		int m_NrOfBinsY{};
+
+		void InitializeScene();
 		void InitializeSoftwareRasterizer();
-		void SoftwareRender() const;
+		// Everything of the sync target that depends on the size, except the depth buffer
+		void AllocateSoftwareTargets();
+		void ResizeSoftwareTargets();
+		// Render size from the output size & scale, true when it changed
+		bool UpdateRenderSize();
+		void UpdateDynamicResolution();
+		void SoftwareRender();
 		void VertexProjectionToScreenSpace(Vertex_Out& vertex) const;
+		Vector3 GetKeyLightDirection() const;
+		// Tangent space needs the world space frame for these, only the key light comes in per vertex
+		bool HasLightsBesidesKeyLight() const { return static_cast<int>(m_Lights.size()) > (m_KeyLightIdx >= 0 ? 1 : 0); }
 
 		bool IsTriangleCulled(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2) const;
 
-		void RenderPixel(int px, int py, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area) const;
+		// Rasterizes the part of the triangle's bounding box that lies in [rectMin, rectMax)
+		void RasterizeRect(const Pixel2D& rectMin, const Pixel2D& rectMax, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		void ResolveHeatmap() const;
+
+		Mesh<Vertex_PosTex>* GetRasterizedMesh() const;
+		void SetupAndBinTriangles(RasterizerStats& stats);
+		void RasterizeBin(int binIdx, RasterizerStats& stats);
+
+		// Lazy clears, per tile of the bound target
+		void ClearTilesOnFirstTouch(const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, RasterizerStats& stats);
+		void ResolveUntouchedTiles();
+		void ClearTile(int tileX, int tileY, bool clearDepth);
+
+		void RenderPixel(int px, int py, Vertex_Out& v0, Vertex_Out& v1, Vertex_Out& v2, float area, RasterizerStats& stats) const;
 		ColorRGB PixelShading(const Vertex_Out& v) const;
+
+		// SIMD path, 2x2 quads of fragments
+		struct QuadWeights
+		{
+			FloatX4 v0;
+			FloatX4 v1;
+			FloatX4 v2;
+			FloatX4 z;
+			FloatX4 w;
+		};
+
+		void RenderQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		// Coverage, z clipping & depth test, returns the lanes that passed
+		int TestQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, QuadWeights& weights, RasterizerStats& stats) const;
+		FragmentQuad InterpolateQuad(int px, int py, int mask, const QuadWeights& weights, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2) const;
+		ColorRGBX4 ShadeQuad(const FragmentQuad& quad) const;
+
+		// Coarse shading, a block of 2x2 coarse pixels of rate x rate pixels gets shaded as one quad
+		void RasterizeRectCoarse(const Pixel2D& rectMin, const Pixel2D& rectMax, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		void RenderCoarseBlock(int px, int py, int rate, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		int GetTileShadingRate(int tileX, int tileY) const;
+		// Weights pulled onto the triangle, for shading points that don't have to be covered themselves
+		QuadWeights CalculateClampedWeights(const FloatX4& pixelX, const FloatX4& pixelY, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area) const;
+
+		// MSAA, the debug views stay on the single sample paths
+		bool IsMsaaActive() const { return m_UseMsaa && !m_ShowOnlyDepthBuffer && !m_ShowOnlyBoundingBoxes; }
+		void AllocateMsaaTargets();
+		void RenderMsaaQuad(int px, int py, const Pixel2D& boundingBoxMin, const Pixel2D& boundingBoxMax, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		// Coverage & depth of one pixel's samples, returns the samples that passed
+		int TestSamples(int px, int py, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float area, RasterizerStats& stats) const;
+		void ResolveMsaaTiles(const Pixel2D& binMin, const Pixel2D& binMax) const;
+		void UpdateTileShadingRates(const Pixel2D& binMin, const Pixel2D& binMax);
 	};
 
 	//--------------------------
@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "ScalingBenchmark.h"
+
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#include "ConsoleColorCtrl.h"
+
+namespace dae
+{
+	const std::vector<ScalingBenchmark::Resolution> ScalingBenchmark::m_Resolutions
+	{
+		{ "480p",	640,	480 },
+		{ "720p",	1280,	720 },
+		{ "1080p",	1920,	1080 },
+		{ "1440p",	2560,	1440 },
+		{ "4K",		3840,	2160 }
+	};
+
+	ScalingBenchmark::ScalingBenchmark(int nrOfMeasuredFrames, StressScene scene) :
+		m_NrOfMeasuredFrames{ nrOfMeasuredFrames },
+		m_Scene{ scene }
+	{
+		// Powers of two, plus every hardware thread when that isn't one already
+		const int nrOfHardwareThreads{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) };
+		for (int nrOfWorkers{ 1 }; nrOfWorkers < nrOfHardwareThreads; nrOfWorkers *= 2) m_WorkerCounts.push_back(nrOfWorkers);
+		m_WorkerCounts.push_back(nrOfHardwareThreads);
+	}
+
+	void ScalingBenchmark::Run()
+	{
+		m_Results.clear();
+
+		for (const Resolution& resolution : m_Resolutions)
+		{
+			float singleWorkerFrameTime{};
+			for (int nrOfWorkers : m_WorkerCounts)
+			{
+				CameraMovementTesting::Settings settings{};
+				settings.width = resolution.width;
+				settings.height = resolution.height;
+				settings.nrOfWarmUpFrames = 10;
+				settings.nrOfMeasuredFrames = m_NrOfMeasuredFrames;
+				settings.nrOfWorkers = nrOfWorkers;
+				settings.scene = m_Scene;
+
+				// A fresh renderer per run, nothing stays warm from the previous worker count
+				const auto pBenchmark = new CameraMovementTesting(settings);
+				pBenchmark->Run();
+				const CameraMovementTesting::FrameSummary summary{ pBenchmark->Summarize() };
+				delete pBenchmark;
+
+				if (nrOfWorkers == 1) singleWorkerFrameTime = summary.mean;
+				const float speedup{ singleWorkerFrameTime / summary.mean };
+				m_Results.push_back({ resolution.name, nrOfWorkers, summary, 1000.f / summary.mean, speedup, speedup / nrOfWorkers });
+
+				std::cout << "	" << resolution.name << ", " << nrOfWorkers << " workers done\n";
+			}
+		}
+	}
+
+	void ScalingBenchmark::PrintTable() const
+	{
+		const auto stageTime = [](const Result& result, ProfileStage stage) { return result.summary.meanStageTimes[static_cast<int>(stage)]; };
+
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
+		std::cout << "**(SOFTWARE) Scaling, " << SceneGenerator::GetSceneName(m_Scene) << ", " << m_NrOfMeasuredFrames << " frames per run [ms]\n" << std::fixed << std::setprecision(2)
+			<< "	" << std::left << std::setw(8) << "RES" << std::right << std::setw(8) << "WORKERS" << std::setw(10) << "MEAN" << std::setw(10) << "P95"
+			<< std::setw(10) << "FPS" << std::setw(10) << "SPEEDUP" << std::setw(8) << "EFF" << std::setw(10) << "BINNING" << std::setw(10) << "RASTER" << std::setw(10) << "CLEAR" << '\n';
+
+		for (const Result& result : m_Results)
+		{
+			std::cout << "	" << std::left << std::setw(8) << result.resolutionName << std::right << std::setw(8) << result.nrOfWorkers
+				<< std::setw(10) << result.summary.mean << std::setw(10) << result.summary.p95 << std::setw(10) << result.framesPerSecond
+				<< std::setw(10) << result.speedup << std::setw(8) << result.efficiency
+				<< std::setw(10) << stageTime(result, ProfileStage::binning) << std::setw(10) << stageTime(result, ProfileStage::rasterization)
+				<< std::setw(10) << stageTime(result, ProfileStage::clear) << '\n';
+		}
+		std::cout << std::defaultfloat << std::flush;
+	}
+
+	bool ScalingBenchmark::WriteCsv(const std::string& filePath) const
+	{
+		if (m_Results.empty()) return false;
+
+		std::ofstream file{ filePath };
+		if (!file) return false;
+
+		file << "resolution,workers,msMean,msP95,fps,speedup,efficiency";
+		for (int stageIdx{}; stageIdx < static_cast<int>(ProfileStage::ENUM_END); ++stageIdx)
+		{
+			file << ",ms" << FrameProfiler::GetStageName(static_cast<ProfileStage>(stageIdx));
+		}
+		file << '\n';
+
+		for (const Result& result : m_Results)
+		{
+			file << result.resolutionName << ',' << result.nrOfWorkers << ',' << result.summary.mean << ',' << result.summary.p95 << ','
+				<< result.framesPerSecond << ',' << result.speedup << ',' << result.efficiency;
+			for (float stageTime : result.summary.meanStageTimes) file << ',' << stageTime;
+			file << '\n';
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "CameraMovementTesting.h"
+
+namespace dae
+{
+	// Sweeps output resolutions & raster worker counts over the scripted camera path,
+	// speedup & efficiency are relative to one worker at the same resolution
+	class ScalingBenchmark final
+	{
+	public:
+		explicit ScalingBenchmark(int nrOfMeasuredFrames = 120, StressScene scene = StressScene::vehicle);
+		~ScalingBenchmark() = default;
+
+		ScalingBenchmark(const ScalingBenchmark& other) = delete;
+		ScalingBenchmark operator=(const ScalingBenchmark& other) = delete;
+		ScalingBenchmark(ScalingBenchmark&& other) = delete;
+		ScalingBenchmark operator=(ScalingBenchmark&& other) = delete;
+
+		void Run();
+		void PrintTable() const;
+		bool WriteCsv(const std::string& filePath) const;
+
+	private:
+		struct Resolution
+		{
+			const char* name;
+			int width;
+			int height;
+		};
+
+		struct Result
+		{
+			const char* resolutionName;
+			int nrOfWorkers;
+			CameraMovementTesting::FrameSummary summary;
+			float framesPerSecond;
+			float speedup;
+			float efficiency;
+		};
+
+		static const std::vector<Resolution> m_Resolutions;
+
+		int m_NrOfMeasuredFrames;
+		StressScene m_Scene;
+		std::vector<int> m_WorkerCounts{};
+		std::vector<Result> m_Results{};
+	};
+}
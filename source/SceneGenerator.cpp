@@ -0,0 +1,228 @@
+#include "pch.h"
+#include "SceneGenerator.h"
+
+#include <random>
+#include <cstring>
+
+#include "Mesh.h"
+
+namespace dae
+{
+	Mesh<Vertex_PosTex>* SceneGenerator::Create(StressScene scene, ID3D11Device* pDevice)
+	{
+		switch (scene)
+		{
+		case StressScene::sphere:			return CreateSphere(pDevice);
+		case StressScene::instanceGrid:		return CreateInstanceGrid(pDevice);
+		case StressScene::tinyTriangles:	return CreateTinyTriangles(pDevice);
+		case StressScene::hugeTriangles:	return CreateHugeTriangles(pDevice);
+		case StressScene::overdrawStack:	return CreateOverdrawStack(pDevice);
+		case StressScene::vehicle:
+		case StressScene::ENUM_END:			break;
+		}
+
+		return nullptr;
+	}
+
+	Mesh<Vertex_PosTex>* SceneGenerator::CreateSphere(ID3D11Device* pDevice, float radius, int nrOfRings, int nrOfSegments)
+	{
+		std::vector<Vertex_PosTex> vertices{};
+		std::vector<uint32_t> indices{};
+		AddSphere(vertices, indices, Vector3::Zero, radius, nrOfRings, nrOfSegments);
+
+		return new Mesh<Vertex_PosTex>{ pDevice, std::move(vertices), std::move(indices), EffectType::PosTex };
+	}
+
+	Mesh<Vertex_PosTex>* SceneGenerator::CreateInstanceGrid(ID3D11Device* pDevice, int nrOfInstancesX, int nrOfInstancesY, float spacing, int nrOfRings, int nrOfSegments)
+	{
+		std::vector<Vertex_PosTex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		// One mesh, the instances are baked in. Gaps between them keep the bins from filling up evenly
+		const float startX{ -.5f * spacing * static_cast<float>(nrOfInstancesX - 1) };
+		const float startY{ -.5f * spacing * static_cast<float>(nrOfInstancesY - 1) };
+		for (int instanceY{}; instanceY < nrOfInstancesY; ++instanceY)
+		{
+			for (int instanceX{}; instanceX < nrOfInstancesX; ++instanceX)
+			{
+				const Vector3 center{ startX + spacing * static_cast<float>(instanceX), startY + spacing * static_cast<float>(instanceY), 0.f };
+				AddSphere(vertices, indices, center, spacing * .4f, nrOfRings, nrOfSegments);
+			}
+		}
+
+		return new Mesh<Vertex_PosTex>{ pDevice, std::move(vertices), std::move(indices), EffectType::PosTex };
+	}
+
+	Mesh<Vertex_PosTex>* SceneGenerator::CreateTinyTriangles(ID3D11Device* pDevice, int nrOfTriangles, float triangleSize, uint32_t seed)
+	{
+		std::vector<Vertex_PosTex> vertices{};
+		std::vector<uint32_t> indices{};
+		vertices.reserve(nrOfTriangles * 3);
+		indices.reserve(nrOfTriangles * 3);
+
+		std::mt19937 generator{ seed };
+		std::uniform_real_distribution<float> xDistribution{ -20.f, 20.f };
+		std::uniform_real_distribution<float> yDistribution{ -15.f, 15.f };
+		std::uniform_real_distribution<float> zDistribution{ -5.f, 5.f };
+		std::uniform_real_distribution<float> uvDistribution{ 0.f, 1.f };
+
+		// Around a pixel each at the start pose, all facing the camera
+		const Vector3 normal{ -Vector3::UnitZ };
+		for (int triangleIdx{}; triangleIdx < nrOfTriangles; ++triangleIdx)
+		{
+			// One draw per statement, so the scene is the same whatever order a compiler evaluates constructor arguments in
+			const float x{ xDistribution(generator) };
+			const float y{ yDistribution(generator) };
+			const float z{ zDistribution(generator) };
+			const float u{ uvDistribution(generator) };
+			const float v{ uvDistribution(generator) };
+
+			const Vector3 origin{ x, y, z };
+			const Vector2 uv{ u, v };
+			const uint32_t firstIdx{ static_cast<uint32_t>(vertices.size()) };
+
+			vertices.push_back({ origin, uv, normal, CalculateTangent(normal) });
+			vertices.push_back({ origin + Vector3{ triangleSize, 0.f, 0.f }, uv, normal, CalculateTangent(normal) });
+			vertices.push_back({ origin + Vector3{ 0.f, triangleSize, 0.f }, uv, normal, CalculateTangent(normal) });
+			AddTriangle(vertices, indices, firstIdx, firstIdx + 1, firstIdx + 2);
+		}
+
+		return new Mesh<Vertex_PosTex>{ pDevice, std::move(vertices), std::move(indices), EffectType::PosTex };
+	}
+
+	Mesh<Vertex_PosTex>* SceneGenerator::CreateHugeTriangles(ID3D11Device* pDevice, int nrOfTriangles)
+	{
+		std::vector<Vertex_PosTex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		// Alternating pointing up & down, each one a unit further away, so later ones mostly fail the depth test where they overlap
+		const Vector3 normal{ -Vector3::UnitZ };
+		for (int triangleIdx{}; triangleIdx < nrOfTriangles; ++triangleIdx)
+		{
+			const float z{ static_cast<float>(triangleIdx) };
+			const float tipY{ triangleIdx % 2 == 0 ? 18.f : -18.f };
+			const uint32_t firstIdx{ static_cast<uint32_t>(vertices.size()) };
+
+			vertices.push_back({ { -24.f, -tipY, z }, { 0.f, 1.f }, normal, CalculateTangent(normal) });
+			vertices.push_back({ { 0.f, tipY, z }, { .5f, 0.f }, normal, CalculateTangent(normal) });
+			vertices.push_back({ { 24.f, -tipY, z }, { 1.f, 1.f }, normal, CalculateTangent(normal) });
+			AddTriangle(vertices, indices, firstIdx, firstIdx + 1, firstIdx + 2);
+		}
+
+		return new Mesh<Vertex_PosTex>{ pDevice, std::move(vertices), std::move(indices), EffectType::PosTex };
+	}
+
+	Mesh<Vertex_PosTex>* SceneGenerator::CreateOverdrawStack(ID3D11Device* pDevice, int nrOfLayers, float layerSpacing, bool isBackToFront)
+	{
+		std::vector<Vertex_PosTex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		for (int layerIdx{}; layerIdx < nrOfLayers; ++layerIdx)
+		{
+			// Submission order decides how much the depth test can save
+			const int depthIdx{ isBackToFront ? nrOfLayers - 1 - layerIdx : layerIdx };
+			AddQuad(vertices, indices, { 0.f, 0.f, static_cast<float>(depthIdx) * layerSpacing }, 24.f, 18.f);
+		}
+
+		return new Mesh<Vertex_PosTex>{ pDevice, std::move(vertices), std::move(indices), EffectType::PosTex };
+	}
+
+	const char* SceneGenerator::GetSceneName(StressScene scene)
+	{
+		switch (scene)
+		{
+		case StressScene::vehicle:			return "vehicle";
+		case StressScene::sphere:			return "sphere";
+		case StressScene::instanceGrid:		return "instanceGrid";
+		case StressScene::tinyTriangles:	return "tinyTriangles";
+		case StressScene::hugeTriangles:	return "hugeTriangles";
+		case StressScene::overdrawStack:	return "overdrawStack";
+		case StressScene::ENUM_END:			break;
+		}
+
+		return "unknown";
+	}
+
+	StressScene SceneGenerator::GetSceneFromName(const char* name)
+	{
+		for (int sceneIdx{}; sceneIdx < static_cast<int>(StressScene::ENUM_END); ++sceneIdx)
+		{
+			if (std::strcmp(name, GetSceneName(static_cast<StressScene>(sceneIdx))) == 0) return static_cast<StressScene>(sceneIdx);
+		}
+
+		return StressScene::ENUM_END;
+	}
+
+	void SceneGenerator::AddQuad(std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, const Vector3& center, float halfWidth, float halfHeight)
+	{
+		const Vector3 normal{ -Vector3::UnitZ };
+		const uint32_t firstIdx{ static_cast<uint32_t>(vertices.size()) };
+
+		vertices.push_back({ center + Vector3{ -halfWidth, halfHeight, 0.f }, { 0.f, 0.f }, normal, CalculateTangent(normal) });
+		vertices.push_back({ center + Vector3{ halfWidth, halfHeight, 0.f }, { 1.f, 0.f }, normal, CalculateTangent(normal) });
+		vertices.push_back({ center + Vector3{ halfWidth, -halfHeight, 0.f }, { 1.f, 1.f }, normal, CalculateTangent(normal) });
+		vertices.push_back({ center + Vector3{ -halfWidth, -halfHeight, 0.f }, { 0.f, 1.f }, normal, CalculateTangent(normal) });
+
+		AddTriangle(vertices, indices, firstIdx, firstIdx + 1, firstIdx + 2);
+		AddTriangle(vertices, indices, firstIdx, firstIdx + 2, firstIdx + 3);
+	}
+
+	void SceneGenerator::AddTriangle(const std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, uint32_t i0, uint32_t i1, uint32_t i2)
+	{
+		const Vertex_PosTex& v0{ vertices[i0] };
+		const Vertex_PosTex& v1{ vertices[i1] };
+		const Vertex_PosTex& v2{ vertices[i2] };
+
+		// Same sense as the loaded OBJs: clockwise seen from the front, which puts the edge cross product along the normal
+		const Vector3 faceNormal{ Vector3::Cross(v1.position - v0.position, v2.position - v0.position) };
+		const bool isFlipped{ Vector3::Dot(faceNormal, v0.normal + v1.normal + v2.normal) < 0.f };
+
+		indices.push_back(i0);
+		indices.push_back(isFlipped ? i2 : i1);
+		indices.push_back(isFlipped ? i1 : i2);
+	}
+
+	void SceneGenerator::AddSphere(std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, const Vector3& center, float radius, int nrOfRings, int nrOfSegments)
+	{
+		const uint32_t firstIdx{ static_cast<uint32_t>(vertices.size()) };
+
+		// UV sphere, the seam column is duplicated so the uvs wrap
+		for (int ringIdx{}; ringIdx <= nrOfRings; ++ringIdx)
+		{
+			const float v{ static_cast<float>(ringIdx) / static_cast<float>(nrOfRings) };
+			const float polarAngle{ v * PI };
+
+			for (int segmentIdx{}; segmentIdx <= nrOfSegments; ++segmentIdx)
+			{
+				const float u{ static_cast<float>(segmentIdx) / static_cast<float>(nrOfSegments) };
+				const float azimuth{ u * 2.f * PI };
+
+				const Vector3 normal{ sinf(polarAngle) * cosf(azimuth), cosf(polarAngle), sinf(polarAngle) * sinf(azimuth) };
+				// Along the azimuth, stays defined at the poles unlike the generic one
+				const Vector3 tangent{ -sinf(azimuth), 0.f, cosf(azimuth) };
+				vertices.push_back({ center + normal * radius, { u, v }, normal, tangent });
+			}
+		}
+
+		const uint32_t nrOfColumns{ static_cast<uint32_t>(nrOfSegments) + 1 };
+		for (uint32_t ringIdx{}; ringIdx < static_cast<uint32_t>(nrOfRings); ++ringIdx)
+		{
+			for (uint32_t segmentIdx{}; segmentIdx < static_cast<uint32_t>(nrOfSegments); ++segmentIdx)
+			{
+				const uint32_t topLeft{ firstIdx + ringIdx * nrOfColumns + segmentIdx };
+				const uint32_t bottomLeft{ topLeft + nrOfColumns };
+
+				// The pole rows collapse one of the two into a zero area triangle, skip those
+				if (ringIdx != 0) AddTriangle(vertices, indices, topLeft, topLeft + 1, bottomLeft);
+				if (ringIdx != static_cast<uint32_t>(nrOfRings) - 1) AddTriangle(vertices, indices, topLeft + 1, bottomLeft + 1, bottomLeft);
+			}
+		}
+	}
+
+	Vector3 SceneGenerator::CalculateTangent(const Vector3& normal)
+	{
+		// Any vector perpendicular to the normal will do for flat generated surfaces
+		const Vector3 axis{ std::abs(normal.y) < .99f ? Vector3::UnitY : Vector3::UnitX };
+		return Vector3::Cross(axis, normal).Normalized();
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+#include "Structs.h"
+
+namespace dae
+{
+	template<typename T_Vertex>
+	class Mesh;
+
+	// Synthetic meshes that each push on one part of the software pipeline
+	enum class StressScene
+	{
+		vehicle,		// Nothing generated, the regular scene
+		sphere,			// Many evenly sized triangles, vertex transform & setup
+		instanceGrid,	// Lots of small separate objects spread over the whole screen, binning
+		tinyTriangles,	// Pixel sized triangles, setup cost per covered pixel
+		hugeTriangles,	// A handful of screen filling triangles, pure fill rate & shading
+		overdrawStack,	// Screen sized layers on top of each other, depth test & overdraw
+		ENUM_END
+	};
+
+	// Meshes are centered on the origin and sized for the vehicle's spot 50 units in front of the start camera.
+	// The software path has no clipping, triangles leaving the screen get rejected whole, so everything stays inside the start view
+	class SceneGenerator final
+	{
+	public:
+		// Caller owns the mesh, nullptr for StressScene::vehicle
+		static Mesh<Vertex_PosTex>* Create(StressScene scene, ID3D11Device* pDevice = nullptr);
+
+		static Mesh<Vertex_PosTex>* CreateSphere(ID3D11Device* pDevice, float radius = 15.f, int nrOfRings = 128, int nrOfSegments = 256);
+		static Mesh<Vertex_PosTex>* CreateInstanceGrid(ID3D11Device* pDevice, int nrOfInstancesX = 24, int nrOfInstancesY = 18, float spacing = 2.f, int nrOfRings = 8, int nrOfSegments = 16);
+		static Mesh<Vertex_PosTex>* CreateTinyTriangles(ID3D11Device* pDevice, int nrOfTriangles = 200000, float triangleSize = .08f, uint32_t seed = 1337);
+		static Mesh<Vertex_PosTex>* CreateHugeTriangles(ID3D11Device* pDevice, int nrOfTriangles = 4);
+		// Back to front puts every layer through shading, front to back lets the depth test reject all but the first
+		static Mesh<Vertex_PosTex>* CreateOverdrawStack(ID3D11Device* pDevice, int nrOfLayers = 32, float layerSpacing = .25f, bool isBackToFront = true);
+
+		static const char* GetSceneName(StressScene scene);
+		// StressScene::ENUM_END when the name is unknown
+		static StressScene GetSceneFromName(const char* name);
+
+	private:
+		// Facing the camera at the start pose, two triangles
+		static void AddQuad(std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, const Vector3& center, float halfWidth, float halfHeight);
+		// Flips the winding when needed, so the triangle's front faces along its vertex normals
+		static void AddTriangle(const std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, uint32_t i0, uint32_t i1, uint32_t i2);
+		static void AddSphere(std::vector<Vertex_PosTex>& vertices, std::vector<uint32_t>& indices, const Vector3& center, float radius, int nrOfRings, int nrOfSegments);
+		static Vector3 CalculateTangent(const Vector3& normal);
+	};
+}
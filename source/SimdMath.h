@@ -0,0 +1,112 @@
+#pragma once
+#include <emmintrin.h>
+
+#include "ColorRGB.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// Four floats processed side by side with SSE, one lane per fragment of a 2x2 quad
+	struct FloatX4
+	{
+		__m128 v;
+
+		FloatX4() : v{ _mm_setzero_ps() } {}
+		FloatX4(__m128 _v) : v{ _v } {}
+		FloatX4(float s) : v{ _mm_set1_ps(s) } {}
+		FloatX4(float l0, float l1, float l2, float l3) : v{ _mm_setr_ps(l0, l1, l2, l3) } {}
+
+		static FloatX4 Load(const float* pLanes) { return _mm_loadu_ps(pLanes); }
+		void Store(float* pLanes) const { _mm_storeu_ps(pLanes, v); }
+
+		// Bit i is set when lane i's mask is set
+		int MoveMask() const { return _mm_movemask_ps(v); }
+
+		static FloatX4 Min(const FloatX4& a, const FloatX4& b) { return _mm_min_ps(a.v, b.v); }
+		static FloatX4 Max(const FloatX4& a, const FloatX4& b) { return _mm_max_ps(a.v, b.v); }
+		static FloatX4 Sqrt(const FloatX4& a) { return _mm_sqrt_ps(a.v); }
+		static FloatX4 Clamp(const FloatX4& a, float min, float max) { return Min(Max(a, min), max); }
+
+		// Lanes of a where the mask is set, lanes of b elsewhere
+		static FloatX4 Select(const FloatX4& mask, const FloatX4& a, const FloatX4& b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+
+		// Lanes where the mask isn't set become 0
+		static FloatX4 Mask(const FloatX4& mask, const FloatX4& a) { return _mm_and_ps(mask.v, a.v); }
+
+		FloatX4 operator+(const FloatX4& o) const { return _mm_add_ps(v, o.v); }
+		FloatX4 operator-(const FloatX4& o) const { return _mm_sub_ps(v, o.v); }
+		FloatX4 operator*(const FloatX4& o) const { return _mm_mul_ps(v, o.v); }
+		FloatX4 operator/(const FloatX4& o) const { return _mm_div_ps(v, o.v); }
+		FloatX4 operator-() const { return _mm_sub_ps(_mm_setzero_ps(), v); }
+		FloatX4& operator+=(const FloatX4& o) { v = _mm_add_ps(v, o.v); return *this; }
+		FloatX4& operator*=(const FloatX4& o) { v = _mm_mul_ps(v, o.v); return *this; }
+
+		// Comparisons return a lane mask
+		FloatX4 operator<(const FloatX4& o) const { return _mm_cmplt_ps(v, o.v); }
+		FloatX4 operator<=(const FloatX4& o) const { return _mm_cmple_ps(v, o.v); }
+		FloatX4 operator>(const FloatX4& o) const { return _mm_cmpgt_ps(v, o.v); }
+		FloatX4 operator>=(const FloatX4& o) const { return _mm_cmpge_ps(v, o.v); }
+		FloatX4 operator&(const FloatX4& o) const { return _mm_and_ps(v, o.v); }
+		FloatX4 operator|(const FloatX4& o) const { return _mm_or_ps(v, o.v); }
+	};
+
+	struct Vector3X4
+	{
+		FloatX4 x{};
+		FloatX4 y{};
+		FloatX4 z{};
+
+		Vector3X4() = default;
+		Vector3X4(const FloatX4& _x, const FloatX4& _y, const FloatX4& _z) : x{ _x }, y{ _y }, z{ _z } {}
+		Vector3X4(const Vector3& v) : x{ v.x }, y{ v.y }, z{ v.z } {}
+
+		FloatX4 Normalize()
+		{
+			const FloatX4 m{ FloatX4::Sqrt(Dot(*this, *this)) };
+			x = x / m;
+			y = y / m;
+			z = z / m;
+			return m;
+		}
+
+		static FloatX4 Dot(const Vector3X4& v1, const Vector3X4& v2) { return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+		static Vector3X4 Cross(const Vector3X4& v1, const Vector3X4& v2)
+		{
+			return { v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x };
+		}
+		static Vector3X4 Select(const FloatX4& mask, const Vector3X4& a, const Vector3X4& b)
+		{
+			return { FloatX4::Select(mask, a.x, b.x), FloatX4::Select(mask, a.y, b.y), FloatX4::Select(mask, a.z, b.z) };
+		}
+
+		Vector3X4 operator+(const Vector3X4& o) const { return { x + o.x, y + o.y, z + o.z }; }
+		Vector3X4 operator-(const Vector3X4& o) const { return { x - o.x, y - o.y, z - o.z }; }
+		Vector3X4 operator*(const FloatX4& s) const { return { x * s, y * s, z * s }; }
+		Vector3X4 operator-() const { return { -x, -y, -z }; }
+	};
+
+	struct ColorRGBX4
+	{
+		FloatX4 r{};
+		FloatX4 g{};
+		FloatX4 b{};
+
+		ColorRGBX4() = default;
+		ColorRGBX4(const FloatX4& _r, const FloatX4& _g, const FloatX4& _b) : r{ _r }, g{ _g }, b{ _b } {}
+		ColorRGBX4(const ColorRGB& c) : r{ c.r }, g{ c.g }, b{ c.b } {}
+
+		ColorRGB GetLane(int lane) const
+		{
+			alignas(16) float rLanes[4], gLanes[4], bLanes[4];
+			_mm_store_ps(rLanes, r.v);
+			_mm_store_ps(gLanes, g.v);
+			_mm_store_ps(bLanes, b.v);
+			return { rLanes[lane], gLanes[lane], bLanes[lane] };
+		}
+
+		ColorRGBX4 operator+(const ColorRGBX4& o) const { return { r + o.r, g + o.g, b + o.b }; }
+		ColorRGBX4 operator*(const ColorRGBX4& o) const { return { r * o.r, g * o.g, b * o.b }; }
+		ColorRGBX4 operator*(const FloatX4& s) const { return { r * s, g * s, b * s }; }
+		ColorRGBX4& operator+=(const ColorRGBX4& o) { r += o.r; g += o.g; b += o.b; return *this; }
+	};
+}
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "SoftwarePresenter.h"
+#include "DepthBuffer.h"
+#include "TraceRecorder.h"
+
+namespace dae
+{
+	SoftwarePresenter::SoftwarePresenter(SDL_Window* pWindow, int width, int height) :
+		m_pWindow{ pWindow },
+		m_pFrontBuffer{ SDL_GetWindowSurface(pWindow) }
+	{
+		for (RenderTarget& target : m_Targets)
+		{
+			target.pColor = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
+			target.pColorPixels = static_cast<uint32_t*>(target.pColor->pixels);
+			target.pDepth = new DepthBuffer{ width, height };
+
+			target.nrOfTilesX = (width + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+			target.nrOfTilesY = (height + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+			target.pTileEpochs = new uint32_t[target.nrOfTilesX * target.nrOfTilesY]{};
+		}
+
+		m_Thread = std::thread{ &SoftwarePresenter::PresentLoop, this };
+	}
+
+	SoftwarePresenter::~SoftwarePresenter()
+	{
+		Flush(); // The present thread could be waiting for its last frame to be shown
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_IsQuitting = true;
+		}
+		m_Condition.notify_all();
+		m_Thread.join();
+
+		for (RenderTarget& target : m_Targets)
+		{
+			SDL_FreeSurface(target.pColor);
+			delete target.pDepth;
+			delete[] target.pTileEpochs;
+		}
+	}
+
+	const RenderTarget& SoftwarePresenter::AcquireTarget()
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		WaitShowingFrames(lock, [this] { return !m_IsTargetBusy[m_CurrentTarget]; });
+
+		return m_Targets[m_CurrentTarget];
+	}
+
+	void SoftwarePresenter::Submit()
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			WaitShowingFrames(lock, [this] { return m_QueuedTarget == -1; });
+
+			m_QueuedTarget = m_CurrentTarget;
+			m_IsTargetBusy[m_CurrentTarget] = true;
+			m_CurrentTarget = (m_CurrentTarget + 1) % m_NrOfTargets;
+		}
+		m_Condition.notify_all();
+	}
+
+	void SoftwarePresenter::UpdateWindow()
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		if (m_IsWindowUpdatePending) ShowPendingFrame(lock);
+	}
+
+	void SoftwarePresenter::Flush()
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		WaitShowingFrames(lock, [this]
+			{
+				return !m_IsWindowUpdatePending && m_QueuedTarget == -1
+					&& std::none_of(std::begin(m_IsTargetBusy), std::end(m_IsTargetBusy), [](bool isBusy) { return isBusy; });
+			});
+	}
+
+	void SoftwarePresenter::WaitShowingFrames(std::unique_lock<std::mutex>& lock, const std::function<bool()>& isDone)
+	{
+		// The present thread can be waiting for its last blit to be shown, which only this thread can do
+		while (true)
+		{
+			m_Condition.wait(lock, [&] { return m_IsWindowUpdatePending || isDone(); });
+			if (isDone()) return;
+			ShowPendingFrame(lock);
+		}
+	}
+
+	void SoftwarePresenter::ShowPendingFrame(std::unique_lock<std::mutex>& lock)
+	{
+		// The present thread doesn't blit while the flag is set, so the surface stays put without holding the lock
+		lock.unlock();
+		SDL_UpdateWindowSurface(m_pWindow);
+		lock.lock();
+
+		m_IsWindowUpdatePending = false;
+		m_Condition.notify_all();
+	}
+
+	void SoftwarePresenter::Resize(int width, int height)
+	{
+		Flush();
+
+		// Nothing is queued or being presented anymore, the present thread is waiting & won't touch the targets
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_pFrontBuffer = SDL_GetWindowSurface(m_pWindow);
+
+		for (RenderTarget& target : m_Targets)
+		{
+			SDL_FreeSurface(target.pColor);
+			target.pColor = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
+			target.pColorPixels = static_cast<uint32_t*>(target.pColor->pixels);
+			target.pDepth->Resize(width, height);
+
+			target.nrOfTilesX = (width + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+			target.nrOfTilesY = (height + RenderTarget::clearTileSize - 1) / RenderTarget::clearTileSize;
+			delete[] target.pTileEpochs;
+			target.pTileEpochs = new uint32_t[target.nrOfTilesX * target.nrOfTilesY]{};
+		}
+	}
+
+	void SoftwarePresenter::PresentLoop()
+	{
+		TraceRecorder::GetInstance()->SetThreadName("Present Thread");
+
+		while (true)
+		{
+			int targetIdx{};
+			{
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				m_Condition.wait(lock, [this] { return m_QueuedTarget != -1 || m_IsQuitting; });
+
+				// A frame that's still queued gets shown before quitting
+				if (m_QueuedTarget == -1) return;
+
+				targetIdx = m_QueuedTarget;
+				m_QueuedTarget = -1;
+			}
+			m_Condition.notify_all(); // Queue has room again
+
+			// The previous frame has to be on screen before the window surface gets overwritten
+			{
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				m_Condition.wait(lock, [this] { return !m_IsWindowUpdatePending || m_IsQuitting; });
+			}
+
+			// The copy the synchronous path does, just off the main thread. Showing it is up to the main thread
+			{
+				TraceScope traceScope{ "Present" };
+				m_Upscaler.Blit(m_Targets[targetIdx].pColor, m_pFrontBuffer);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_IsTargetBusy[targetIdx] = false;
+				m_IsWindowUpdatePending = true;
+			}
+			m_Condition.notify_all();
+		}
+	}
+}
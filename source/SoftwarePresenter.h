@@ -0,0 +1,80 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "Upscaler.h"
+
+struct SDL_Window;
+struct SDL_Surface;
+
+namespace dae
+{
+	class DepthBuffer;
+
+	// Color + depth target the software rasterizer draws into
+	struct RenderTarget
+	{
+		// Tiles get cleared the first time a triangle touches them, untouched ones only get the clear color at resolve
+		static constexpr int clearTileSize{ 16 };
+
+		SDL_Surface* pColor{};
+		uint32_t* pColorPixels{};
+		DepthBuffer* pDepth{};
+
+		uint32_t* pTileEpochs{};	// Frame each tile was last cleared in
+		int nrOfTilesX{};
+		int nrOfTilesY{};
+	};
+
+	// Presents software frames on its own thread, frame N gets blitted while frame N + 1 is rasterized
+	// Two target pairs and a queue that holds one finished frame, so latency never grows past a single frame
+	// SDL only updates a window from the thread that created it, so the main thread shows the blitted frame with UpdateWindow
+	class SoftwarePresenter
+	{
+	public:
+		SoftwarePresenter(SDL_Window* pWindow, int width, int height);
+		~SoftwarePresenter();
+
+		SoftwarePresenter(const SoftwarePresenter& other) = delete;
+		SoftwarePresenter operator=(const SoftwarePresenter& other) = delete;
+		SoftwarePresenter(SoftwarePresenter&& other) = delete;
+		SoftwarePresenter operator=(SoftwarePresenter&& other) = delete;
+
+		// Main thread only, like every call below. Blocks until the next target is neither queued nor being presented
+		const RenderTarget& AcquireTarget();
+		// Hands the acquired target to the present thread, blocks while the previous frame is still waiting in the queue
+		void Submit();
+		// Once per frame: shows the frame the present thread blitted last, if there's a new one. Doesn't block
+		void UpdateWindow();
+		// Blocks until every submitted frame is on screen, call before anything else touches the window surface
+		void Flush();
+		// Flushes, then reallocates both targets at the new size & picks up the new window surface
+		void Resize(int width, int height);
+
+	private:
+		static constexpr int m_NrOfTargets{ 2 };
+
+		SDL_Window* m_pWindow{};
+		SDL_Surface* m_pFrontBuffer{};
+		Upscaler m_Upscaler{};	// Targets are at the render size, which can be below the window's
+
+		RenderTarget m_Targets[m_NrOfTargets]{};
+		bool m_IsTargetBusy[m_NrOfTargets]{};	// Queued or being presented
+		int m_CurrentTarget{};
+		int m_QueuedTarget{ -1 };				// The bounded queue, -1 when empty
+		bool m_IsWindowUpdatePending{ false };	// Blitted into the window surface, the next blit waits until the main thread showed it
+		bool m_IsQuitting{ false };
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_Condition{};
+		std::thread m_Thread{};
+
+		void PresentLoop();
+		// Main thread waits, keeps showing blitted frames until isDone holds
+		void WaitShowingFrames(std::unique_lock<std::mutex>& lock, const std::function<bool()>& isDone);
+		// With the mutex held & an update pending, unlocks around the SDL call
+		void ShowPendingFrame(std::unique_lock<std::mutex>& lock);
+	};
+}
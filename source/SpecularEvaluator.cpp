@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "SpecularEvaluator.h"
+
+namespace dae
+{
+	SpecularEvaluator::SpecularEvaluator(float shininess)
+		: m_Shininess{ shininess }
+	{
+		m_Table.resize(static_cast<size_t>(m_NrOfGlossLevels) * (m_NrOfCosSteps + 1));
+
+		for (int glossIdx{}; glossIdx < m_NrOfGlossLevels; ++glossIdx)
+		{
+			const float exponent{ static_cast<float>(glossIdx) / 255.f * m_Shininess };
+			float* pRow{ &m_Table[static_cast<size_t>(glossIdx) * (m_NrOfCosSteps + 1)] };
+			for (int cosIdx{}; cosIdx <= m_NrOfCosSteps; ++cosIdx)
+			{
+				pRow[cosIdx] = powf(static_cast<float>(cosIdx) / m_NrOfCosSteps, exponent);
+			}
+		}
+
+		for (int mode{}; mode < static_cast<int>(SpecularMode::ENUM_END); ++mode)
+		{
+			m_MaxErrors[mode] = MeasureMaxError(static_cast<SpecularMode>(mode));
+		}
+	}
+
+	float SpecularEvaluator::Evaluate(float cosAlpha, float gloss, SpecularMode mode) const
+	{
+		switch (mode)
+		{
+		case SpecularMode::lookupTable:
+			return Lookup(cosAlpha, gloss);
+		case SpecularMode::approximation:
+			return Approximate(cosAlpha, gloss);
+		case SpecularMode::ENUM_END: // Should not be possible, in here for warning suppression
+		case SpecularMode::exact:
+			return Exact(cosAlpha, gloss);
+		}
+		return Exact(cosAlpha, gloss);
+	}
+
+	float SpecularEvaluator::Exact(float cosAlpha, float gloss) const
+	{
+		return powf(cosAlpha, gloss * m_Shininess);
+	}
+
+	float SpecularEvaluator::Lookup(float cosAlpha, float gloss) const
+	{
+		// The first step is too steep for small exponents to interpolate linearly, it's also rare since cosAlpha is clamped to exactly 0
+		constexpr float firstStep{ 1.f / m_NrOfCosSteps };
+		if (cosAlpha > 0.f && cosAlpha < firstStep) return Exact(cosAlpha, gloss);
+
+		const int glossIdx{ Clamp(static_cast<int>(gloss * 255.f + .5f), 0, m_NrOfGlossLevels - 1) };
+		const float* pRow{ &m_Table[static_cast<size_t>(glossIdx) * (m_NrOfCosSteps + 1)] };
+
+		const float scaledCos{ Clamp(cosAlpha, 0.f, 1.f) * m_NrOfCosSteps };
+		const int cosIdx{ std::min(static_cast<int>(scaledCos), m_NrOfCosSteps - 1) };
+		const float fraction{ scaledCos - static_cast<float>(cosIdx) };
+
+		return Lerpf(pRow[cosIdx], pRow[cosIdx + 1], fraction);
+	}
+
+	float SpecularEvaluator::Approximate(float cosAlpha, float gloss) const
+	{
+		// powf(x, y) = exp2(y * log2(x)), both evaluated with short polynomials
+		const float exponent{ gloss * m_Shininess };
+		if (cosAlpha <= 0.f) return exponent > 0.f ? 0.f : 1.f;
+
+		return FastExp2(exponent * FastLog2(cosAlpha));
+	}
+
+	FloatX4 SpecularEvaluator::EvaluateX4(const FloatX4& cosAlpha, const FloatX4& gloss, SpecularMode mode) const
+	{
+		if (mode == SpecularMode::approximation) return ApproximateX4(cosAlpha, gloss);
+
+		alignas(16) float cosLanes[4], glossLanes[4], resultLanes[4];
+		cosAlpha.Store(cosLanes);
+		gloss.Store(glossLanes);
+		for (int lane{}; lane < 4; ++lane)
+		{
+			resultLanes[lane] = Evaluate(cosLanes[lane], glossLanes[lane], mode);
+		}
+		return FloatX4::Load(resultLanes);
+	}
+
+	FloatX4 SpecularEvaluator::ApproximateX4(const FloatX4& cosAlpha, const FloatX4& gloss) const
+	{
+		const FloatX4 exponent{ gloss * m_Shininess };
+		const FloatX4 result{ FastExp2X4(exponent * FastLog2X4(cosAlpha)) };
+
+		// cosAlpha <= 0 has no logarithm: 0 for a positive exponent, 1 for exponent 0
+		const FloatX4 atZero{ FloatX4::Select(exponent > 0.f, 0.f, 1.f) };
+		return FloatX4::Select(cosAlpha > 0.f, result, atZero);
+	}
+
+	float SpecularEvaluator::GetMaxError(SpecularMode mode) const
+	{
+		return m_MaxErrors[static_cast<int>(mode)];
+	}
+
+	float SpecularEvaluator::GetShininess() const
+	{
+		return m_Shininess;
+	}
+
+	float SpecularEvaluator::MeasureMaxError(SpecularMode mode) const
+	{
+		if (mode == SpecularMode::exact) return 0.f;
+
+		// Every gloss byte against a cosAlpha grid that's finer than the table, so in between entries are tested too
+		constexpr int nrOfCosSamples{ 4 * m_NrOfCosSteps + 3 };
+		float maxError{};
+		for (int glossIdx{}; glossIdx < m_NrOfGlossLevels; ++glossIdx)
+		{
+			const float gloss{ static_cast<float>(glossIdx) / 255.f };
+			for (int cosIdx{}; cosIdx <= nrOfCosSamples; ++cosIdx)
+			{
+				const float cosAlpha{ static_cast<float>(cosIdx) / nrOfCosSamples };
+				const float error{ fabsf(Evaluate(cosAlpha, gloss, mode) - Exact(cosAlpha, gloss)) };
+				maxError = std::max(maxError, error);
+			}
+		}
+		return maxError;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstring>
+#include "SimdMath.h"
+
+namespace dae
+{
+	enum class SpecularMode
+	{
+		exact,
+		lookupTable,
+		approximation,
+		ENUM_END
+	};
+
+	// Evaluates the phong lobe powf(cosAlpha, gloss * shininess) for 8-bit gloss texels,
+	// either exactly or through one of the cheaper paths
+	class SpecularEvaluator
+	{
+	public:
+		explicit SpecularEvaluator(float shininess);
+		~SpecularEvaluator() = default;
+
+		SpecularEvaluator(const SpecularEvaluator& other) = delete;
+		SpecularEvaluator operator=(const SpecularEvaluator& other) = delete;
+		SpecularEvaluator(SpecularEvaluator&& other) = delete;
+		SpecularEvaluator operator=(SpecularEvaluator&& other) = delete;
+
+		float Evaluate(float cosAlpha, float gloss, SpecularMode mode) const;
+
+		float Exact(float cosAlpha, float gloss) const;
+		float Lookup(float cosAlpha, float gloss) const;
+		float Approximate(float cosAlpha, float gloss) const;
+
+		// Four lanes at once, only the approximation is truly vectorized, the other modes run per lane
+		FloatX4 EvaluateX4(const FloatX4& cosAlpha, const FloatX4& gloss, SpecularMode mode) const;
+		FloatX4 ApproximateX4(const FloatX4& cosAlpha, const FloatX4& gloss) const;
+
+		// Largest absolute difference with the exact path, measured once at construction
+		float GetMaxError(SpecularMode mode) const;
+		float GetShininess() const;
+
+		static float FastLog2(float x);
+		static float FastExp2(float x);
+		static FloatX4 FastLog2X4(const FloatX4& x);
+		static FloatX4 FastExp2X4(const FloatX4& x);
+
+	private:
+		static constexpr int m_NrOfGlossLevels{ 256 };
+		static constexpr int m_NrOfCosSteps{ 256 };
+
+		const float m_Shininess;
+
+		// Row per gloss byte, m_NrOfCosSteps + 1 entries so the last step can be interpolated towards cosAlpha = 1
+		std::vector<float> m_Table{};
+
+		float m_MaxErrors[static_cast<int>(SpecularMode::ENUM_END)]{};
+
+		float MeasureMaxError(SpecularMode mode) const;
+	};
+
+	//--------------------------
+	// Inline definitions
+	//--------------------------
+	inline float SpecularEvaluator::FastLog2(float x)
+	{
+		// x = mantissa * 2^exponent, mantissa in [1, 2), polynomial fit of log2 on the mantissa
+		uint32_t bits{};
+		std::memcpy(&bits, &x, sizeof(float));
+		const float exponent{ static_cast<float>(static_cast<int>(bits >> 23) - 127) };
+		bits = (bits & 0x007FFFFF) | 0x3F800000;
+
+		float m{};
+		std::memcpy(&m, &bits, sizeof(float));
+		m -= 1.f;
+
+		const float polynomial{ 1.439093075e-05f + m * (1.441592077e+00f + m * (-7.072534333e-01f + m * (4.115614816e-01f + m * (-1.898324457e-01f + m * 4.392862752e-02f)))) };
+		return exponent + polynomial;
+	}
+
+	inline float SpecularEvaluator::FastExp2(float x)
+	{
+		// 2^x = 2^floor(x) * 2^fraction, polynomial fit of 2^fraction on [0, 1)
+		x = std::max(x, -126.f);
+		const float floored{ floorf(x) };
+		const float f{ x - floored };
+
+		const float polynomial{ 9.999998958e-01f + f * (6.931546200e-01f + f * (2.401407703e-01f + f * (5.586328211e-02f + f * (8.946215293e-03f + f * 1.895107042e-03f)))) };
+
+		uint32_t bits{ static_cast<uint32_t>(static_cast<int>(floored) + 127) << 23 };
+		float scale{};
+		std::memcpy(&scale, &bits, sizeof(float));
+		return polynomial * scale;
+	}
+
+	inline FloatX4 SpecularEvaluator::FastLog2X4(const FloatX4& x)
+	{
+		// Same split & polynomial as FastLog2
+		const __m128i bits{ _mm_castps_si128(x.v) };
+		const FloatX4 exponent{ _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127))) };
+		const FloatX4 m{ FloatX4{ _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000))) } - 1.f };
+
+		const FloatX4 polynomial{ FloatX4{ 1.439093075e-05f } + m * (FloatX4{ 1.441592077e+00f } + m * (FloatX4{ -7.072534333e-01f } + m * (FloatX4{ 4.115614816e-01f } + m * (FloatX4{ -1.898324457e-01f } + m * 4.392862752e-02f)))) };
+		return exponent + polynomial;
+	}
+
+	inline FloatX4 SpecularEvaluator::FastExp2X4(const FloatX4& x)
+	{
+		// Same split & polynomial as FastExp2. SSE2 has no floor: truncate, then step down where that rounded up
+		const FloatX4 clamped{ FloatX4::Max(x, -126.f) };
+		const FloatX4 truncated{ _mm_cvtepi32_ps(_mm_cvttps_epi32(clamped.v)) };
+		const FloatX4 floored{ truncated - FloatX4::Mask(truncated > clamped, 1.f) };
+		const FloatX4 f{ clamped - floored };
+
+		const FloatX4 polynomial{ FloatX4{ 9.999998958e-01f } + f * (FloatX4{ 6.931546200e-01f } + f * (FloatX4{ 2.401407703e-01f } + f * (FloatX4{ 5.586328211e-02f } + f * (FloatX4{ 8.946215293e-03f } + f * 1.895107042e-03f)))) };
+
+		const __m128i bits{ _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(floored.v), _mm_set1_epi32(127)), 23) };
+		return polynomial * FloatX4{ _mm_castsi128_ps(bits) };
+	}
+}
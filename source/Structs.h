@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Vector3.h"
 #include "Vector4.h"
+#include "SimdMath.h"
 namespace dae
 {
 	struct Pixel2D
@@ -24,6 +25,27 @@ namespace dae
 		Vector3 normal{};
 		Vector3 tangent{};
 		Vector3 viewDirection{};
+		Vector3 tangentLightDirection{};
+		Vector3 tangentViewDirection{};
+		Vector3 worldPosition{};
+	};
+
+	// A 2x2 block of fragments, one SIMD lane each: (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1)
+	struct FragmentQuad
+	{
+		int x{};
+		int y{};
+		int mask{};	// Bit per lane that is covered and passed the depth test
+
+		FloatX4 depth{};
+		FloatX4 u{};
+		FloatX4 v{};
+		Vector3X4 normal{};
+		Vector3X4 tangent{};
+		Vector3X4 viewDirection{};
+		Vector3X4 tangentLightDirection{};
+		Vector3X4 tangentViewDirection{};
+		Vector3X4 worldPosition{};
 	};
 
 	struct Vertex_PosCol
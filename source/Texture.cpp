@@ -7,7 +7,7 @@ namespace dae
 	// DUAL RASTERIZER
 	//--------------------------------------
 #pragma region Common_Functions
-	Texture::Texture(const std::string& path, ID3D11Device* pDevice)
+	Texture::Texture(const std::string& path, [[maybe_unused]] ID3D11Device* pDevice)
 	{
 		m_pSurface = IMG_Load(path.c_str());
 		if(m_pSurface == nullptr)
@@ -18,6 +18,9 @@ namespace dae
 
 		m_pSurfacePixels = static_cast<uint32_t*>(m_pSurface->pixels);
 
+#ifndef DISABLE_DIRECTX
+		if (pDevice == nullptr) return; // Headless, software rasterizer only
+
 		DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
 		D3D11_TEXTURE2D_DESC desc{};
 		desc.Width = m_pSurface->w;
@@ -44,13 +47,16 @@ namespace dae
 		SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 		SRVDesc.Texture2D.MipLevels = 1;
 		result = pDevice->CreateShaderResourceView(m_pResource, &SRVDesc, &m_pShaderResourceView);
+#endif
 	}
 
 	Texture::~Texture()
 	{
+#ifndef DISABLE_DIRECTX
 		// Release DirectX Resources
 		if(m_pShaderResourceView) m_pShaderResourceView->Release();
 		if(m_pResource) m_pResource->Release();
+#endif
 
 		// Release Software Shader SDL Surface
 		if(m_pSurface)
@@ -65,10 +71,12 @@ namespace dae
 	// HARDWARE RASTERIZER
 	//--------------------------------------
 #pragma region Hardware_Rasterizer
+#ifndef DISABLE_DIRECTX
 	ID3D11ShaderResourceView* Texture::GetSRV()
 	{
 		return m_pShaderResourceView;
 	}
+#endif
 #pragma endregion
 
 	//--------------------------------------
@@ -88,5 +96,23 @@ namespace dae
 
 		return { static_cast<float>(r) / 255.f, static_cast<float>(g) / 255.f, static_cast<float>(b) / 255.f };
 	}
+
+	ColorRGB Texture::GetTexel(int px, int py) const
+	{
+		Uint8 r{}, g{}, b{};
+		SDL_GetRGB(m_pSurfacePixels[px + m_pSurface->w * py], m_pSurface->format, &r, &g, &b);
+
+		return { static_cast<float>(r) / 255.f, static_cast<float>(g) / 255.f, static_cast<float>(b) / 255.f };
+	}
+
+	int Texture::GetWidth() const
+	{
+		return m_pSurface->w;
+	}
+
+	int Texture::GetHeight() const
+	{
+		return m_pSurface->h;
+	}
 #pragma endregion
 }
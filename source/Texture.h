@@ -5,7 +5,7 @@ namespace dae
 	class Texture
 	{
 	public:
-		// Dual Rasterizer
+		// Dual Rasterizer, without a device only the software side gets loaded (headless)
 		Texture(const std::string& path, ID3D11Device* pDevice);
 		~Texture();
 
@@ -14,16 +14,23 @@ namespace dae
 		Texture(Texture&& other) = delete;
 		Texture operator=(Texture&& other) = delete;
 
+#ifndef DISABLE_DIRECTX
 		// Hardware Rasterizer
 		ID3D11ShaderResourceView* GetSRV();
+#endif
 
 		// Software Rasterizer
 		ColorRGB Sample(const Vector2& uv) const;
+		ColorRGB GetTexel(int px, int py) const;
+		int GetWidth() const;
+		int GetHeight() const;
 
 	private:
+#ifndef DISABLE_DIRECTX
 		// Hardware Rasterizer
-		ID3D11Texture2D* m_pResource;
-		ID3D11ShaderResourceView* m_pShaderResourceView;
+		ID3D11Texture2D* m_pResource{ nullptr };
+		ID3D11ShaderResourceView* m_pShaderResourceView{ nullptr };
+#endif
 
 		// Software Rasterizer
 		SDL_Surface* m_pSurface{ nullptr };
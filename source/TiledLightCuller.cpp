@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "TiledLightCuller.h"
+#include <cassert>
+#include "Camera.h"
+
+namespace dae
+{
+	TiledLightCuller::TiledLightCuller(int width, int height)
+	{
+		Resize(width, height);
+	}
+
+	void TiledLightCuller::Resize(int width, int height)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_NrOfTilesX = (width + m_TileSize - 1) / m_TileSize;
+		m_NrOfTilesY = (height + m_TileSize - 1) / m_TileSize;
+
+		// Cull fills every tile again, so the old contents don't matter
+		const size_t nrOfTiles{ static_cast<size_t>(m_NrOfTilesX) * m_NrOfTilesY };
+		m_TileOffsets.resize(nrOfTiles);
+		m_TileCounts.resize(nrOfTiles);
+	}
+
+	void TiledLightCuller::Cull(const std::vector<Light>& lights, const Camera& camera)
+	{
+		assert(lights.size() <= UINT16_MAX);
+
+		// 1) Tile rect of every light, counting how many lights end up in each tile
+		std::fill(m_TileCounts.begin(), m_TileCounts.end(), static_cast<uint16_t>(0));
+		m_LightRects.resize(lights.size());
+
+		for (size_t lightIdx{}; lightIdx < lights.size(); ++lightIdx)
+		{
+			const TileRect rect{ CalculateTileRect(lights[lightIdx], camera) };
+			m_LightRects[lightIdx] = rect;
+
+			for (int tileY{ rect.minY }; tileY <= rect.maxY; ++tileY)
+			{
+				for (int tileX{ rect.minX }; tileX <= rect.maxX; ++tileX)
+				{
+					++m_TileCounts[tileX + tileY * m_NrOfTilesX];
+				}
+			}
+		}
+
+		// 2) Prefix sum, so every tile's list is contiguous
+		uint32_t offset{};
+		for (size_t tileIdx{}; tileIdx < m_TileCounts.size(); ++tileIdx)
+		{
+			m_TileOffsets[tileIdx] = offset;
+			offset += m_TileCounts[tileIdx];
+		}
+		m_TileLightIndices.resize(offset);
+
+		// 3) Fill the lists, lights stay in their original order within a tile
+		std::fill(m_TileCounts.begin(), m_TileCounts.end(), static_cast<uint16_t>(0));
+		for (size_t lightIdx{}; lightIdx < lights.size(); ++lightIdx)
+		{
+			const TileRect& rect{ m_LightRects[lightIdx] };
+			for (int tileY{ rect.minY }; tileY <= rect.maxY; ++tileY)
+			{
+				for (int tileX{ rect.minX }; tileX <= rect.maxX; ++tileX)
+				{
+					const int tileIdx{ tileX + tileY * m_NrOfTilesX };
+					m_TileLightIndices[m_TileOffsets[tileIdx] + m_TileCounts[tileIdx]] = static_cast<uint16_t>(lightIdx);
+					++m_TileCounts[tileIdx];
+				}
+			}
+		}
+	}
+
+	const uint16_t* TiledLightCuller::GetTileLights(int px, int py, int& nrOfLights) const
+	{
+		const int tileIdx{ px / m_TileSize + (py / m_TileSize) * m_NrOfTilesX };
+		nrOfLights = m_TileCounts[tileIdx];
+		return m_TileLightIndices.data() + m_TileOffsets[tileIdx];
+	}
+
+	TiledLightCuller::TileRect TiledLightCuller::CalculateTileRect(const Light& light, const Camera& camera) const
+	{
+		const TileRect allTiles{ 0, 0, m_NrOfTilesX - 1, m_NrOfTilesY - 1 };
+		if (light.type == LightType::directional) return allTiles;
+
+		// Bounding sphere of the light's range in view space, spots are treated like points
+		const Vector3 center{ camera.viewMatrix.TransformPoint(light.origin) };
+		const float radius{ light.range };
+
+		if (center.z + radius < camera.nearPlane) return TileRect{}; // Entirely behind the camera
+		if (center.z - radius < camera.nearPlane) return allTiles;	 // Straddles the near plane, projecting the box would flip signs
+
+		// Project the corners of the sphere's view space box, the extremes of x / z and y / z are always at a corner
+		const float scaleX{ camera.projectionMatrix[0].x };
+		const float scaleY{ camera.projectionMatrix[1].y };
+
+		float ndcMinX{ FLT_MAX }, ndcMinY{ FLT_MAX };
+		float ndcMaxX{ -FLT_MAX }, ndcMaxY{ -FLT_MAX };
+		for (const float z : { center.z - radius, center.z + radius })
+		{
+			for (const float x : { center.x - radius, center.x + radius })
+			{
+				ndcMinX = std::min(ndcMinX, x * scaleX / z);
+				ndcMaxX = std::max(ndcMaxX, x * scaleX / z);
+			}
+			for (const float y : { center.y - radius, center.y + radius })
+			{
+				ndcMinY = std::min(ndcMinY, y * scaleY / z);
+				ndcMaxY = std::max(ndcMaxY, y * scaleY / z);
+			}
+		}
+
+		if (ndcMinX > 1.f || ndcMaxX < -1.f || ndcMinY > 1.f || ndcMaxY < -1.f) return TileRect{}; // Off screen
+
+		// NDC to pixels (y flips) to tiles
+		const float minPixelX{ (Clamp(ndcMinX, -1.f, 1.f) + 1) / 2 * static_cast<float>(m_Width) };
+		const float maxPixelX{ (Clamp(ndcMaxX, -1.f, 1.f) + 1) / 2 * static_cast<float>(m_Width) };
+		const float minPixelY{ (1 - Clamp(ndcMaxY, -1.f, 1.f)) / 2 * static_cast<float>(m_Height) };
+		const float maxPixelY{ (1 - Clamp(ndcMinY, -1.f, 1.f)) / 2 * static_cast<float>(m_Height) };
+
+		TileRect rect{};
+		rect.minX = Clamp(static_cast<int>(minPixelX) / m_TileSize, 0, m_NrOfTilesX - 1);
+		rect.maxX = Clamp(static_cast<int>(maxPixelX) / m_TileSize, 0, m_NrOfTilesX - 1);
+		rect.minY = Clamp(static_cast<int>(minPixelY) / m_TileSize, 0, m_NrOfTilesY - 1);
+		rect.maxY = Clamp(static_cast<int>(maxPixelY) / m_TileSize, 0, m_NrOfTilesY - 1);
+		return rect;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Light.h"
+
+namespace dae
+{
+	struct Camera;
+
+	// Assigns lights to screen tiles, so a fragment only has to loop over the lights that can reach its tile
+	class TiledLightCuller
+	{
+	public:
+		TiledLightCuller(int width, int height);
+		~TiledLightCuller() = default;
+
+		TiledLightCuller(const TiledLightCuller& other) = delete;
+		TiledLightCuller operator=(const TiledLightCuller& other) = delete;
+		TiledLightCuller(TiledLightCuller&& other) = delete;
+		TiledLightCuller operator=(TiledLightCuller&& other) = delete;
+
+		void Resize(int width, int height);
+		void Cull(const std::vector<Light>& lights, const Camera& camera);
+
+		// Indices into the culled light vector, for the tile the pixel lies in
+		const uint16_t* GetTileLights(int px, int py, int& nrOfLights) const;
+
+		static constexpr int GetTileSize() { return m_TileSize; }
+
+	private:
+		struct TileRect
+		{
+			int minX{};
+			int minY{};
+			int maxX{ -1 };	// Inclusive, an empty rect has max < min
+			int maxY{ -1 };
+		};
+
+		static constexpr int m_TileSize{ 16 };
+
+		int m_Width{};
+		int m_Height{};
+		int m_NrOfTilesX{};
+		int m_NrOfTilesY{};
+
+		std::vector<TileRect> m_LightRects{};
+		std::vector<uint32_t> m_TileOffsets{};	// Start of every tile's list in m_TileLightIndices
+		std::vector<uint16_t> m_TileCounts{};
+		std::vector<uint16_t> m_TileLightIndices{};
+
+		TileRect CalculateTileRect(const Light& light, const Camera& camera) const;
+	};
+}
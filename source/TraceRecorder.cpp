@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "TraceRecorder.h"
+#include <fstream>
+
+namespace dae
+{
+	TraceRecorder::TraceRecorder() :
+		m_StartTicks{ SDL_GetPerformanceCounter() },
+		m_MicrosecondsPerTick{ 1'000'000.0 / static_cast<double>(SDL_GetPerformanceFrequency()) }
+	{
+	}
+
+	TraceRecorder* TraceRecorder::GetInstance()
+	{
+		// The present thread & the raster workers can get here first as well, static init is the one that can't race
+		static TraceRecorder instance{};
+		return &instance;
+	}
+
+	void TraceRecorder::SetThreadName(const char* name)
+	{
+		ThreadBufferOwner& owner{ GetThreadBufferOwner() };
+		owner.threadName = name;
+		if (owner.pBuffer) owner.pBuffer->threadName.store(name, std::memory_order_relaxed);
+	}
+
+	void TraceRecorder::Record(const char* name, char phase)
+	{
+		if (!IsEnabled()) return;
+
+		// Single producer per ring, the release store publishes the event to WriteJson
+		ThreadBuffer* pBuffer{ GetThreadBuffer() };
+		const uint64_t eventIdx{ pBuffer->nrOfEvents.load(std::memory_order_relaxed) };
+		pBuffer->events[eventIdx & (m_RingSize - 1)] = { name, SDL_GetPerformanceCounter(), phase };
+		pBuffer->nrOfEvents.store(eventIdx + 1, std::memory_order_release);
+	}
+
+	TraceRecorder::ThreadBuffer* TraceRecorder::GetThreadBuffer()
+	{
+		ThreadBufferOwner& owner{ GetThreadBufferOwner() };
+		if (owner.pBuffer) return owner.pBuffer;
+
+		// The buffer stays owned by m_pThreadBuffers, so WriteJson can still read it after the thread is gone
+		std::lock_guard<std::mutex> lock{ m_RegistrationMutex };
+		m_pThreadBuffers.push_back(std::make_unique<ThreadBuffer>());
+		owner.pBuffer = m_pThreadBuffers.back().get();
+		owner.pBuffer->threadIdx = m_NrOfRegisteredThreads++;
+		owner.pBuffer->threadName.store(owner.threadName, std::memory_order_relaxed);
+
+		return owner.pBuffer;
+	}
+
+	void TraceRecorder::ReleaseThreadBuffer(ThreadBuffer* pBuffer)
+	{
+		std::lock_guard<std::mutex> lock{ m_RegistrationMutex };
+
+		// Events that never made it into a file keep the buffer alive until the next WriteJson
+		if (pBuffer->nrOfEvents.load(std::memory_order_relaxed) != pBuffer->nrOfEventsWritten)
+		{
+			pBuffer->isRetired = true;
+			return;
+		}
+
+		std::erase_if(m_pThreadBuffers, [pBuffer](const std::unique_ptr<ThreadBuffer>& pOther) { return pOther.get() == pBuffer; });
+	}
+
+	TraceRecorder::ThreadBufferOwner& TraceRecorder::GetThreadBufferOwner()
+	{
+		thread_local ThreadBufferOwner owner{};
+		return owner;
+	}
+
+	bool TraceRecorder::WriteJson(const std::string& filePath)
+	{
+		std::lock_guard<std::mutex> lock{ m_RegistrationMutex };
+
+		std::ofstream file{ filePath };
+		if (!file) return false;
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool isFirstEvent{ true };
+		const auto writeEvent = [&](const char* name, char phase, double timestamp, int threadIdx)
+		{
+			file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"" << phase
+				<< "\",\"ts\":" << std::fixed << timestamp << ",\"pid\":1,\"tid\":" << threadIdx << '}';
+			isFirstEvent = false;
+		};
+
+		std::vector<const ThreadBuffer*> pRetiredBuffers{};
+		for (const std::unique_ptr<ThreadBuffer>& pBuffer : m_pThreadBuffers)
+		{
+			// A retired thread can't add events anymore, everything it recorded gets written below
+			if (pBuffer->isRetired) pRetiredBuffers.push_back(pBuffer.get());
+
+			if (const char* threadName{ pBuffer->threadName.load(std::memory_order_relaxed) })
+			{
+				file << (isFirstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pBuffer->threadIdx
+					<< ",\"args\":{\"name\":\"" << threadName << "\"}}";
+				isFirstEvent = false;
+			}
+
+			// The counter only ever goes up, this side keeps track of how far it got instead of resetting it
+			const uint64_t nrOfEvents{ pBuffer->nrOfEvents.load(std::memory_order_acquire) };
+			const uint64_t firstEventIdx{ std::max(pBuffer->nrOfEventsWritten, nrOfEvents > m_RingSize ? nrOfEvents - m_RingSize : 0) };
+
+			// Ends whose begin got overwritten are dropped, begins that never ended get closed at the last timestamp
+			std::vector<const char*> openEvents{};
+			double lastTimestamp{};
+			for (uint64_t eventIdx{ firstEventIdx }; eventIdx < nrOfEvents; ++eventIdx)
+			{
+				const Event& event{ pBuffer->events[eventIdx & (m_RingSize - 1)] };
+				lastTimestamp = static_cast<double>(event.ticks - m_StartTicks) * m_MicrosecondsPerTick;
+
+				if (event.phase == 'B')
+				{
+					openEvents.push_back(event.name);
+				}
+				else
+				{
+					if (openEvents.empty()) continue;
+					openEvents.pop_back();
+				}
+
+				writeEvent(event.name, event.phase, lastTimestamp, pBuffer->threadIdx);
+			}
+
+			while (!openEvents.empty())
+			{
+				writeEvent(openEvents.back(), 'E', lastTimestamp, pBuffer->threadIdx);
+				openEvents.pop_back();
+			}
+
+			pBuffer->nrOfEventsWritten = nrOfEvents;
+		}
+
+		// Threads that exited are written out completely, their buffers can go
+		std::erase_if(m_pThreadBuffers, [&pRetiredBuffers](const std::unique_ptr<ThreadBuffer>& pBuffer)
+			{
+				return std::find(pRetiredBuffers.begin(), pRetiredBuffers.end(), pBuffer.get()) != pRetiredBuffers.end();
+			});
+
+		file << "\n]}\n";
+		return true;
+	}
+}
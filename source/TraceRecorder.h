@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+
+namespace dae
+{
+	// Begin/end events of every thread, written out as a chrome://tracing / Perfetto JSON file
+	// Each thread records into its own ring buffer, so recording never takes a lock. Names have to be string literals
+	class TraceRecorder
+	{
+	public:
+		// Created on first use, thread safe. Lives until exit, so no thread ever sees it go away
+		static TraceRecorder* GetInstance();
+
+		void SetEnabled(bool isEnabled) { m_IsEnabled.store(isEnabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return m_IsEnabled.load(std::memory_order_relaxed); }
+
+		void Begin(const char* name) { Record(name, 'B'); }
+		void End(const char* name) { Record(name, 'E'); }
+		// Only remembered until the thread records, threads that never trace while it's enabled never get a buffer
+		void SetThreadName(const char* name);
+
+		// Only while no other thread is recording. Writes the events recorded since the last write
+		bool WriteJson(const std::string& filePath);
+
+	private:
+		TraceRecorder();
+
+		static constexpr uint64_t m_RingSize{ 1 << 16 }; // Power of two, oldest events get overwritten
+
+		struct Event
+		{
+			const char* name{};
+			uint64_t ticks{};
+			char phase{};
+		};
+
+		struct ThreadBuffer
+		{
+			int threadIdx{};
+			std::atomic<const char*> threadName{};
+			std::atomic<uint64_t> nrOfEvents{};		// Only the owning thread writes it, it never goes back
+			uint64_t nrOfEventsWritten{};			// Under m_RegistrationMutex, everything before it is in a file already
+			bool isRetired{ false };				// Under m_RegistrationMutex, the owning thread exited before all of it got written
+			Event events[m_RingSize]{};
+		};
+
+		// Thread local handle on a thread's buffer, hands it back when the thread exits
+		struct ThreadBufferOwner
+		{
+			ThreadBuffer* pBuffer{};
+			const char* threadName{};
+			~ThreadBufferOwner() { if (pBuffer) GetInstance()->ReleaseThreadBuffer(pBuffer); }
+		};
+
+		std::atomic<bool> m_IsEnabled{ false };
+		uint64_t m_StartTicks{};
+		double m_MicrosecondsPerTick{};
+
+		std::mutex m_RegistrationMutex{};	// Only taken the first time a thread records
+		std::vector<std::unique_ptr<ThreadBuffer>> m_pThreadBuffers{};
+		int m_NrOfRegisteredThreads{};		// Thread ids in the JSON, never reused
+
+		void Record(const char* name, char phase);
+		ThreadBuffer* GetThreadBuffer();
+		void ReleaseThreadBuffer(ThreadBuffer* pBuffer);
+
+		static ThreadBufferOwner& GetThreadBufferOwner();
+	};
+
+	// Traces the enclosing scope
+	class TraceScope final
+	{
+	public:
+		explicit TraceScope(const char* name) : m_Name{ name } { TraceRecorder::GetInstance()->Begin(m_Name); }
+		~TraceScope() { TraceRecorder::GetInstance()->End(m_Name); }
+
+		TraceScope(const TraceScope& other) = delete;
+		TraceScope operator=(const TraceScope& other) = delete;
+		TraceScope(TraceScope&& other) = delete;
+		TraceScope operator=(TraceScope&& other) = delete;
+
+	private:
+		const char* m_Name;
+	};
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "Upscaler.h"
+
+#include <emmintrin.h>
+
+namespace dae
+{
+	void Upscaler::Blit(SDL_Surface* pSource, SDL_Surface* pDestination)
+	{
+		if (pSource->w == pDestination->w && pSource->h == pDestination->h)
+		{
+			SDL_BlitSurface(pSource, nullptr, pDestination, nullptr);
+		}
+		else if (pSource->format->format == pDestination->format->format && pSource->format->BytesPerPixel == 4)
+		{
+			Bilinear(pSource, pDestination);
+		}
+		else
+		{
+			SDL_BlitScaled(pSource, nullptr, pDestination, nullptr);
+		}
+	}
+
+	void Upscaler::Bilinear(const SDL_Surface* pSource, SDL_Surface* pDestination)
+	{
+		const int sourceWidth{ pSource->w };
+		const int sourceHeight{ pSource->h };
+		const int destinationWidth{ pDestination->w };
+		const int destinationHeight{ pDestination->h };
+		if (sourceWidth != m_SourceWidth || destinationWidth != m_DestinationWidth) UpdateColumns(sourceWidth, destinationWidth);
+
+		const int sourcePitch{ pSource->pitch / static_cast<int>(sizeof(uint32_t)) };
+		const int destinationPitch{ pDestination->pitch / static_cast<int>(sizeof(uint32_t)) };
+		const uint32_t* pSourcePixels{ static_cast<const uint32_t*>(pSource->pixels) };
+		uint32_t* pDestinationPixels{ static_cast<uint32_t*>(pDestination->pixels) };
+
+		const float scaleY{ static_cast<float>(sourceHeight) / static_cast<float>(destinationHeight) };
+		const __m128i zero{ _mm_setzero_si128() };
+
+		// a + (b - a) * weight, on two pixels of four 16 bit channels each
+		const auto lerp = [](__m128i a, __m128i b, __m128i weight)
+		{
+			return _mm_add_epi16(a, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(b, a), weight), m_WeightBits));
+		};
+
+		for (int destinationY{}; destinationY < destinationHeight; ++destinationY)
+		{
+			// Pixel centers line up, the edges clamp
+			const float sourceY{ std::max((static_cast<float>(destinationY) + .5f) * scaleY - .5f, 0.f) };
+			const int topRow{ std::min(static_cast<int>(sourceY), sourceHeight - 1) };
+			const int bottomRow{ std::min(topRow + 1, sourceHeight - 1) };
+			const int16_t rowWeight{ static_cast<int16_t>((sourceY - static_cast<float>(topRow)) * (1 << m_WeightBits)) };
+
+			const uint32_t* pTop{ pSourcePixels + topRow * sourcePitch };
+			const uint32_t* pBottom{ pSourcePixels + bottomRow * sourcePitch };
+			uint32_t* pOut{ pDestinationPixels + destinationY * destinationPitch };
+			const __m128i rowWeights{ _mm_set1_epi16(rowWeight) };
+
+			// Two destination pixels per iteration, the source texels get gathered & widened to 16 bits
+			int destinationX{};
+			for (; destinationX + 1 < destinationWidth; destinationX += 2)
+			{
+				const int left0{ m_LeftColumns[destinationX] };
+				const int left1{ m_LeftColumns[destinationX + 1] };
+				const int right0{ m_RightColumns[destinationX] };
+				const int right1{ m_RightColumns[destinationX + 1] };
+
+				const __m128i topLeft{ _mm_unpacklo_epi8(_mm_set_epi32(0, 0, static_cast<int>(pTop[left1]), static_cast<int>(pTop[left0])), zero) };
+				const __m128i topRight{ _mm_unpacklo_epi8(_mm_set_epi32(0, 0, static_cast<int>(pTop[right1]), static_cast<int>(pTop[right0])), zero) };
+				const __m128i bottomLeft{ _mm_unpacklo_epi8(_mm_set_epi32(0, 0, static_cast<int>(pBottom[left1]), static_cast<int>(pBottom[left0])), zero) };
+				const __m128i bottomRight{ _mm_unpacklo_epi8(_mm_set_epi32(0, 0, static_cast<int>(pBottom[right1]), static_cast<int>(pBottom[right0])), zero) };
+
+				const int16_t weight0{ m_ColumnWeights[destinationX] };
+				const int16_t weight1{ m_ColumnWeights[destinationX + 1] };
+				const __m128i columnWeights{ _mm_set_epi16(weight1, weight1, weight1, weight1, weight0, weight0, weight0, weight0) };
+
+				const __m128i top{ lerp(topLeft, topRight, columnWeights) };
+				const __m128i bottom{ lerp(bottomLeft, bottomRight, columnWeights) };
+				const __m128i result{ lerp(top, bottom, rowWeights) };
+
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(pOut + destinationX), _mm_packus_epi16(result, result));
+			}
+
+			// Odd width, the last pixel on its own
+			if (destinationX < destinationWidth)
+			{
+				const __m128i topLeft{ _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pTop[m_LeftColumns[destinationX]])), zero) };
+				const __m128i topRight{ _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pTop[m_RightColumns[destinationX]])), zero) };
+				const __m128i bottomLeft{ _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pBottom[m_LeftColumns[destinationX]])), zero) };
+				const __m128i bottomRight{ _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pBottom[m_RightColumns[destinationX]])), zero) };
+				const __m128i columnWeights{ _mm_set1_epi16(m_ColumnWeights[destinationX]) };
+
+				const __m128i result{ lerp(lerp(topLeft, topRight, columnWeights), lerp(bottomLeft, bottomRight, columnWeights), rowWeights) };
+				pOut[destinationX] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(result, result)));
+			}
+		}
+	}
+
+	void Upscaler::UpdateColumns(int sourceWidth, int destinationWidth)
+	{
+		m_SourceWidth = sourceWidth;
+		m_DestinationWidth = destinationWidth;
+		m_LeftColumns.resize(destinationWidth);
+		m_RightColumns.resize(destinationWidth);
+		m_ColumnWeights.resize(destinationWidth);
+
+		const float scaleX{ static_cast<float>(sourceWidth) / static_cast<float>(destinationWidth) };
+		for (int destinationX{}; destinationX < destinationWidth; ++destinationX)
+		{
+			const float sourceX{ std::max((static_cast<float>(destinationX) + .5f) * scaleX - .5f, 0.f) };
+			const int leftColumn{ std::min(static_cast<int>(sourceX), sourceWidth - 1) };
+
+			m_LeftColumns[destinationX] = leftColumn;
+			m_RightColumns[destinationX] = std::min(leftColumn + 1, sourceWidth - 1);
+			m_ColumnWeights[destinationX] = static_cast<int16_t>((sourceX - static_cast<float>(leftColumn)) * (1 << m_WeightBits));
+		}
+	}
+}
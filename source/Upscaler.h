@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+
+struct SDL_Surface;
+
+namespace dae
+{
+	// Brings a software frame rendered below the window size up to the window surface
+	// Keeps the per column lookups of the last size pair, so one instance per presenting thread
+	class Upscaler final
+	{
+	public:
+		Upscaler() = default;
+		~Upscaler() = default;
+
+		Upscaler(const Upscaler& other) = delete;
+		Upscaler operator=(const Upscaler& other) = delete;
+		Upscaler(Upscaler&& other) = delete;
+		Upscaler operator=(Upscaler&& other) = delete;
+
+		// Plain blit at the same size, bilinear when the pixel layouts match, SDL's scaler otherwise
+		void Blit(SDL_Surface* pSource, SDL_Surface* pDestination);
+
+		// Both 32 bits per pixel in the same layout, every byte gets filtered without knowing which channel it is
+		void Bilinear(const SDL_Surface* pSource, SDL_Surface* pDestination);
+
+	private:
+		static constexpr int m_WeightBits{ 7 };	// (b - a) * weight has to fit in a signed 16 bit lane
+
+		int m_SourceWidth{};
+		int m_DestinationWidth{};
+		std::vector<int> m_LeftColumns{};		// Per destination column, the right neighbour is the next one (clamped)
+		std::vector<int> m_RightColumns{};
+		std::vector<int16_t> m_ColumnWeights{};	// Weight of the right neighbour
+
+		void UpdateColumns(int sourceWidth, int destinationWidth);
+	};
+}
@@ -189,6 +189,39 @@ namespace dae
 			return (1 / (weight0 / v0value + weight1 / v1value + weight2 / v2value));
 		}
 
+		// Black -> blue -> green -> yellow -> red, t in [0, 1]
+		static ColorRGB HeatmapColor(float t)
+		{
+			const ColorRGB stops[]{ { 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 1.f, 0.f }, { 1.f, 1.f, 0.f }, { 1.f, 0.f, 0.f } };
+			constexpr int nrOfSegments{ static_cast<int>(std::size(stops)) - 1 };
+
+			const float scaledT{ Clamp(t, 0.f, 1.f) * nrOfSegments };
+			const int segment{ std::min(static_cast<int>(scaledT), nrOfSegments - 1) };
+			return ColorRGB::Lerp(stops[segment], stops[segment + 1], scaledT - segment);
+		}
+
+		// CalcWeight for the four pixels of a quad
+		static FloatX4 CalcWeightX4(const Vertex_Out& nextVertex, const Vertex_Out& previousVertex, const FloatX4& pixelX, const FloatX4& pixelY, float areaParallelogram)
+		{
+			const float v0ToV1X{ previousVertex.position.x - nextVertex.position.x };
+			const float v0ToV1Y{ previousVertex.position.y - nextVertex.position.y };
+			const FloatX4 v0ToPixelX{ pixelX - nextVertex.position.x };
+			const FloatX4 v0ToPixelY{ pixelY - nextVertex.position.y };
+
+			return (v0ToPixelY * v0ToV1X - v0ToPixelX * v0ToV1Y) / areaParallelogram;
+		}
+
+		static FloatX4 InterpolateX4(float v0value, float v1value, float v2value, const FloatX4& weight0, const FloatX4& weight1, const FloatX4& weight2)
+		{
+			return FloatX4{ 1.f } / (weight0 / v0value + weight1 / v1value + weight2 / v2value);
+		}
+
+		// Attribute interpolation with weights that are already perspective corrected
+		static Vector3X4 InterpolateAttributeX4(const Vector3& v0value, const Vector3& v1value, const Vector3& v2value, const FloatX4& weight0, const FloatX4& weight1, const FloatX4& weight2)
+		{
+			return Vector3X4{ v0value } * weight0 + Vector3X4{ v1value } * weight1 + Vector3X4{ v2value } * weight2;
+		}
+
 		static float CalcAreaParallelogram(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2)
 		{
 			Vector2 v0ToV1{ v1.position.x - v0.position.x, v1.position.y - v0.position.y };
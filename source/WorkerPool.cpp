@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "WorkerPool.h"
+#include "TraceRecorder.h"
+
+namespace dae
+{
+	WorkerPool::WorkerPool(int nrOfWorkers) :
+		m_NrOfWorkers{ std::max(nrOfWorkers, 1) }
+	{
+		m_Threads.reserve(m_NrOfWorkers - 1);
+		for (int workerIdx{ 1 }; workerIdx < m_NrOfWorkers; ++workerIdx)
+		{
+			m_Threads.emplace_back(&WorkerPool::WorkerLoop, this, workerIdx);
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_IsQuitting = true;
+		}
+		m_Condition.notify_all();
+
+		for (std::thread& thread : m_Threads) thread.join();
+	}
+
+	void WorkerPool::Run(int nrOfJobs, const std::function<void(int jobIdx, int workerIdx)>& job)
+	{
+		// Nothing to share, skip the wake ups
+		if (m_NrOfWorkers == 1 || nrOfJobs == 1)
+		{
+			for (int jobIdx{}; jobIdx < nrOfJobs; ++jobIdx) job(jobIdx, 0);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_pJob = &job;
+			m_NrOfJobs = nrOfJobs;
+			m_NextJobIdx.store(0, std::memory_order_relaxed);
+			m_NrOfBusyThreads = m_NrOfWorkers - 1;
+			++m_BatchIdx;
+		}
+		m_Condition.notify_all();
+
+		ProcessJobs(0);
+
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		m_Condition.wait(lock, [this] { return m_NrOfBusyThreads == 0; });
+		m_pJob = nullptr;
+	}
+
+	void WorkerPool::WorkerLoop(int workerIdx)
+	{
+		TraceRecorder::GetInstance()->SetThreadName("Raster Worker");
+
+		uint64_t lastBatchIdx{};
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				m_Condition.wait(lock, [&] { return m_BatchIdx != lastBatchIdx || m_IsQuitting; });
+				if (m_IsQuitting) return;
+
+				lastBatchIdx = m_BatchIdx;
+			}
+
+			ProcessJobs(workerIdx);
+
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				--m_NrOfBusyThreads;
+			}
+			m_Condition.notify_all();
+		}
+	}
+
+	void WorkerPool::ProcessJobs(int workerIdx)
+	{
+		TraceScope traceScope{ "Jobs" };
+
+		for (int jobIdx{ m_NextJobIdx.fetch_add(1, std::memory_order_relaxed) }; jobIdx < m_NrOfJobs; jobIdx = m_NextJobIdx.fetch_add(1, std::memory_order_relaxed))
+		{
+			(*m_pJob)(jobIdx, workerIdx);
+		}
+	}
+}
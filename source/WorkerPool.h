@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace dae
+{
+	// Fixed set of threads that work through one batch of jobs at a time, the thread calling Run works along as worker 0
+	class WorkerPool
+	{
+	public:
+		explicit WorkerPool(int nrOfWorkers);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool& other) = delete;
+		WorkerPool operator=(const WorkerPool& other) = delete;
+		WorkerPool(WorkerPool&& other) = delete;
+		WorkerPool operator=(WorkerPool&& other) = delete;
+
+		// Blocks until every job ran, jobs get handed out in order through one shared counter
+		void Run(int nrOfJobs, const std::function<void(int jobIdx, int workerIdx)>& job);
+
+		int GetNrOfWorkers() const { return m_NrOfWorkers; }
+
+	private:
+		int m_NrOfWorkers;
+
+		const std::function<void(int, int)>* m_pJob{};
+		int m_NrOfJobs{};
+		std::atomic<int> m_NextJobIdx{};
+
+		uint64_t m_BatchIdx{};			// Bumped by Run, wakes the threads
+		int m_NrOfBusyThreads{};
+		bool m_IsQuitting{ false };
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_Condition{};
+		std::vector<std::thread> m_Threads{};
+
+		void WorkerLoop(int workerIdx);
+		void ProcessJobs(int workerIdx);
+	};
+}
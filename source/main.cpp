@@ -1,13 +1,20 @@
 #include "pch.h"
 
-#if defined(_DEBUG)
+#if defined(_DEBUG) && defined(_WIN32)
 #include "vld.h"
 #endif
 
 #undef main
+#include <charconv>
+#include <cstring>
 //#include "Mesh.h"
 #include "Renderer.h"
 #include "ConsoleColorCtrl.h"
+#include "TraceRecorder.h"
+#include "CameraMovementTesting.h"
+#include "GoldenImageTesting.h"
+#include "KernelBenchmarks.h"
+#include "ScalingBenchmark.h"
 
 using namespace dae;
 
@@ -27,7 +34,10 @@ void PrintStartMessage()
 		<< "	[F6] Toggle Normal Map (ON/OFF) (*)\n"
 		<< "	[F9] Cycle Cull Modes (BACK/FRONT/NONE)\n" 
 		<< "	[F10] Toggle Uniform ClearColor [On/Off]\n"
-		<< "	[F11] Toggle Print FPS [On/Off]\n\n";
+		<< "	[F11] Toggle Print FPS [On/Off]\n"
+		<< "	[2] Toggle Light Showcase (ON/OFF)\n"
+		<< "	[8] Toggle Trace Recording (writes Trace.json when stopped)\n"
+		<< "	Resize the window to change the resolution, or start with <width> <height> [<target ms>]\n\n";
 
 	ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_GREEN);
 	std::cout << "[Key Bindings] - HARDWARE\n"
@@ -37,29 +47,235 @@ void PrintStartMessage()
 	ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_PURPLE);
 	std::cout << "[Key Bindings] - SOFTWARE\n"
 		<< "	[F7] Toggle DepthBuffer Visualisation (ON/OFF)\n" 
-		<< "	[F8] Toggle BoundingBoxVisualisation (ON/OFF)\n\n";
+		<< "	[F8] Toggle BoundingBoxVisualisation (ON/OFF)\n"
+		<< "	[F12] Cycle Specular Evaluation (EXACT/LOOKUP_TABLE/APPROXIMATION)\n"
+		<< "	[1] Toggle Lighting Space (WORLD/TANGENT)\n"
+		<< "	[3] Toggle Shading Path (SCALAR/SIMD QUADS)\n"
+		<< "	[4] Toggle Async Present (present thread, replaces zero-copy)\n"
+		<< "	[5] Cycle Depth Format (FLOAT32/FLOAT32 REVERSED-Z/UNORM24/UNORM16, only UNORM16 halves the depth bandwidth)\n"
+		<< "	[6] Cycle Heatmap (OFF/DEPTH TESTS/SHADING INVOCATIONS/TILE TIME)\n"
+		<< "	[7] Print Frame Profile (p50/p95/p99 per stage, CSV of the last 4096 frames written at exit)\n"
+		<< "	[9] Print Rasterizer Stats (last frame)\n"
+		<< "	[0] Cycle Raster Workers (1/2/4/.../ALL HARDWARE THREADS)\n"
+		<< "	[-] Toggle Dynamic Resolution (render scale follows the frame time budget, 3rd start argument in ms)\n"
+		<< "	[=] Cycle Shading Rate (FULL/COARSE 2X2/COARSE 4X4/ADAPTIVE per tile)\n"
+		<< "	[[] Toggle MSAA (OFF/4X, shaded once per pixel)\n"
+		<< "	[]] Toggle FXAA (post process edge blend, compare against MSAA with [7])\n\n";
 
 	ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_WHITE);
 	std::cout << "(*) = Differs from specification document: have been implemented as shared instead of only software\n";
 }
 
+void PrintUsage()
+{
+	std::cout << "Usage:\n"
+		<< "	[<width> <height> [<target ms>]]: windowed, the target turns on dynamic resolution\n"
+		<< "	--help\n"
+		<< "	--headless <width> <height> <output.bmp>\n"
+		<< "	--benchmark [<width> <height> [<warm-up frames> <measured frames> [<output.json> [<scene>]]]]\n"
+		<< "	--golden <record|compare> [simd]: record writes Resources/Golden/ once (scalar, 1 worker), compare needs them\n"
+		<< "	--microbench [<output.json>]\n"
+		<< "	--scaling [<measured frames> [<output.csv> [<scene>]]]\n";
+}
+
+// The whole argument has to be a number of at least minValue, prints the usage otherwise instead of throwing like std::stoi
+template<typename T>
+bool ParseArgument(const char* arg, T& value, T minValue)
+{
+	const char* pEnd{ arg + strlen(arg) };
+	const auto [pParsedEnd, error] { std::from_chars(arg, pEnd, value) };
+	if (error == std::errc{} && pParsedEnd == pEnd && value >= minValue) return true;
+
+	std::cout << "Invalid argument \"" << arg << "\"\n";
+	PrintUsage();
+	return false;
+}
+
+// SDL, the object a command line mode runs on & the console colors, set up once the arguments are parsed and torn down on every return path
+template<typename T>
+class ModeRun final
+{
+public:
+	template<typename... Args>
+	explicit ModeRun(Args&&... args)
+	{
+		SDL_Init(0);
+		m_pMode = new T(std::forward<Args>(args)...);
+	}
+
+	~ModeRun()
+	{
+		ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_WHITE);
+		ConsoleColorCtrl::Destroy();
+		delete m_pMode;
+
+		SDL_Quit();
+	}
+
+	ModeRun(const ModeRun&) = delete;
+	ModeRun(ModeRun&&) noexcept = delete;
+	ModeRun& operator=(const ModeRun&) = delete;
+	ModeRun& operator=(ModeRun&&) noexcept = delete;
+
+	T* operator->() const { return m_pMode; }
+
+private:
+	T* m_pMode{};
+};
+
+// --headless <width> <height> <output.bmp>: one software frame, no window & no DirectX
+int RunHeadless(int width, int height, const char* outputPath)
+{
+	const ModeRun<Renderer> renderer{ width, height };
+	Timer timer{};
+
+	renderer->Update(&timer);
+	renderer->Render();
+
+	// Wrap the finished frame, the renderer keeps ownership of the pixels
+	SDL_Surface* pFrame = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(renderer->GetFramePixels()), width, height, 32,
+		renderer->GetFramePitch(), renderer->GetFrameFormat()->format);
+	const bool isSaved{ pFrame && SDL_SaveBMP(pFrame, outputPath) == 0 };
+	if (isSaved) std::cout << "Headless frame written to " << outputPath << '\n';
+	else std::cout << "Headless frame could not be written to " << outputPath << '\n';
+	SDL_FreeSurface(pFrame);
+
+	return isSaved ? 0 : 1;
+}
+
+// Scene argument of the benchmark modes, lists the valid names when it's not one of them
+StressScene GetStressScene(const char* name)
+{
+	const StressScene scene{ SceneGenerator::GetSceneFromName(name) };
+	if (scene != StressScene::ENUM_END) return scene;
+
+	std::cout << "Unknown scene \"" << name << "\", expected one of:";
+	for (int sceneIdx{}; sceneIdx < static_cast<int>(StressScene::ENUM_END); ++sceneIdx)
+	{
+		std::cout << ' ' << SceneGenerator::GetSceneName(static_cast<StressScene>(sceneIdx));
+	}
+	std::cout << std::endl;
+
+	return StressScene::ENUM_END;
+}
+
+// --benchmark [<width> <height> <warm-up frames> <measured frames> <output.json> <scene>]: scripted camera path, fixed timestep
+int RunBenchmark(int argc, char* args[])
+{
+	CameraMovementTesting::Settings settings{};
+	std::string outputPath{ "Benchmark.json" };
+	if (argc >= 4 && (!ParseArgument(args[2], settings.width, 1) || !ParseArgument(args[3], settings.height, 1))) return 1;
+	if (argc >= 6 && (!ParseArgument(args[4], settings.nrOfWarmUpFrames, 0) || !ParseArgument(args[5], settings.nrOfMeasuredFrames, 1))) return 1;
+	if (argc >= 7) outputPath = args[6];
+	if (argc >= 8) settings.scene = GetStressScene(args[7]);
+	if (settings.scene == StressScene::ENUM_END) return 1;
+
+	const ModeRun<CameraMovementTesting> benchmark{ settings };
+	benchmark->Run();
+	benchmark->PrintSummary();
+	const bool isWritten{ benchmark->WriteJson(outputPath) };
+	if (isWritten) std::cout << "Benchmark written to " << outputPath << '\n';
+
+	return isWritten ? 0 : 1;
+}
+
+// --golden <record|compare> [simd]: shading/culling combinations against Resources/Golden/, exit code is the number of failures
+int RunGoldenImages(int argc, char* args[])
+{
+	GoldenImageTesting::Settings settings{};
+	settings.isRecording = argc >= 3 && std::string{ args[2] } == "record";
+	settings.useSimdShading = argc >= 4 && std::string{ args[3] } == "simd";
+
+	const ModeRun<GoldenImageTesting> goldenImages{ settings };
+	return goldenImages->Run();
+}
+
+// --microbench [<output.json>]: hot kernels in isolation, ns/op & throughput
+int RunKernelBenchmarks(int argc, char* args[])
+{
+	const std::string outputPath{ argc >= 3 ? args[2] : "Microbench.json" };
+
+	const ModeRun<KernelBenchmarks> kernelBenchmarks{};
+	kernelBenchmarks->Run();
+	kernelBenchmarks->PrintResults();
+	const bool isWritten{ kernelBenchmarks->WriteJson(outputPath) };
+	if (isWritten) std::cout << "Kernel benchmarks written to " << outputPath << '\n';
+
+	return isWritten ? 0 : 1;
+}
+
+// --scaling [<measured frames> <output.csv> <scene>]: every resolution from 480p to 4K against every worker count
+int RunScalingBenchmark(int argc, char* args[])
+{
+	int nrOfMeasuredFrames{ 120 };
+	if (argc >= 3 && !ParseArgument(args[2], nrOfMeasuredFrames, 1)) return 1;
+	const std::string outputPath{ argc >= 4 ? args[3] : "Scaling.csv" };
+	const StressScene scene{ argc >= 5 ? GetStressScene(args[4]) : StressScene::vehicle };
+	if (scene == StressScene::ENUM_END) return 1;
+
+	const ModeRun<ScalingBenchmark> scalingBenchmark{ nrOfMeasuredFrames, scene };
+	scalingBenchmark->Run();
+	scalingBenchmark->PrintTable();
+	const bool isWritten{ scalingBenchmark->WriteCsv(outputPath) };
+	if (isWritten) std::cout << "Scaling table written to " << outputPath << '\n';
+
+	return isWritten ? 0 : 1;
+}
+
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	// The mode decides what the rest of the arguments mean, so nothing gets parsed before it's known
+	const std::string mode{ argc >= 2 ? args[1] : "" };
+	if (mode == "--headless")
+	{
+		if (argc < 5)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		int width{}, height{};
+		if (!ParseArgument(args[2], width, 1) || !ParseArgument(args[3], height, 1)) return 1;
+		return RunHeadless(width, height, args[4]);
+	}
+	if (mode == "--benchmark")
+		return RunBenchmark(argc, args);
+	if (mode == "--golden")
+		return RunGoldenImages(argc, args);
+	if (mode == "--microbench")
+		return RunKernelBenchmarks(argc, args);
+	if (mode == "--scaling")
+		return RunScalingBenchmark(argc, args);
+	if (mode == "--help")
+	{
+		PrintUsage();
+		return 0;
+	}
+
+	// Anything else starting with a dash is a mistyped mode, not a window size
+	if (mode.starts_with('-') || argc == 2)
+	{
+		std::cout << "Unknown arguments, starting with \"" << mode << "\"\n";
+		PrintUsage();
+		return 1;
+	}
+
+	// <width> <height> [<target ms>]: start size of the window, it can be resized at runtime either way
+	// The target turns on dynamic resolution for the software rasterizer with that frame time budget
+	int width{ 640 };
+	int height{ 480 };
+	float targetFrameMs{};
+	if (argc >= 3 && (!ParseArgument(args[1], width, 1) || !ParseArgument(args[2], height, 1))) return 1;
+	if (argc >= 4 && !ParseArgument(args[3], targetFrameMs, 0.f)) return 1;
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
 
-	const uint32_t width = 640;
-	const uint32_t height = 480;
-
 	SDL_Window* pWindow = SDL_CreateWindow(
 		"Dual Rasterizer - Rutger Hertoghe (2GD07)",
 		SDL_WINDOWPOS_UNDEFINED,
 		SDL_WINDOWPOS_UNDEFINED,
-		width, height, 0);
+		width, height, SDL_WINDOW_RESIZABLE);
 
 	if (!pWindow)
 		return 1;
@@ -67,6 +283,7 @@ int main(int argc, char* args[])
 	//Initialize "framework"
 	const auto pTimer = new Timer();
 	const auto pRenderer = new Renderer(pWindow);
+	if (targetFrameMs > 0.f) pRenderer->SetDynamicResolution(targetFrameMs);
 
 	PrintStartMessage();
 
@@ -75,9 +292,13 @@ int main(int argc, char* args[])
 	float printTimer = 0.f;
 	bool isLooping = true;
 	bool isPrintingFPS = false;
+	TraceRecorder::GetInstance()->SetThreadName("Main Thread");
 	while (isLooping)
 	{
+		TraceScope frameTrace{ "Frame" };
+
 		//--------- Get input events ---------
+		TraceRecorder::GetInstance()->Begin("Events");
 		SDL_Event e;
 		while (SDL_PollEvent(&e))
 		{
@@ -86,6 +307,12 @@ int main(int argc, char* args[])
 			case SDL_QUIT:
 				isLooping = false;
 				break;
+			case SDL_WINDOWEVENT:
+				if (e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+				{
+					pRenderer->Resize(e.window.data1, e.window.data2);
+				}
+				break;
 			case SDL_KEYUP:
 				//Test for a key
 				if(e.key.keysym.scancode == SDL_SCANCODE_F1)
@@ -132,11 +359,73 @@ int main(int argc, char* args[])
 				{
 					isPrintingFPS = !isPrintingFPS;
 				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+				{
+					pRenderer->CycleSpecularMode();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_1)
+				{
+					pRenderer->ToggleTangentSpaceLighting();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_2)
+				{
+					pRenderer->ToggleLightShowcase();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_3)
+				{
+					pRenderer->ToggleSimdShading();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_4)
+				{
+					pRenderer->ToggleAsyncPresent();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_5)
+				{
+					pRenderer->CycleDepthFormat();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_6)
+				{
+					pRenderer->CycleHeatmapMode();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_7)
+				{
+					pRenderer->PrintFrameProfile();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_8)
+				{
+					pRenderer->ToggleTraceRecording();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_9)
+				{
+					pRenderer->PrintRasterizerStats();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_0)
+				{
+					pRenderer->CycleWorkerCount();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_MINUS)
+				{
+					pRenderer->ToggleDynamicResolution();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_EQUALS)
+				{
+					pRenderer->CycleShadingRate();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_LEFTBRACKET)
+				{
+					pRenderer->ToggleMsaa();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_RIGHTBRACKET)
+				{
+					pRenderer->ToggleFxaa();
+				}
 				break;
 			default: ;
 			}
 		}
 
+		TraceRecorder::GetInstance()->End("Events");
+
 		//--------- Update ---------
 		pRenderer->Update(pTimer);
 
@@ -151,14 +440,15 @@ int main(int argc, char* args[])
 			printTimer = 0.f;
 			if (isPrintingFPS)
 			{
-				HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-				SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_GREEN);
+				ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_WHITE);
 				std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
 			}
 		}
 	}
 	pTimer->Stop();
 
+	if (pRenderer->WriteFrameProfile("FrameProfile.csv")) std::cout << "Frame profile written to FrameProfile.csv\n";
+
 	ConsoleColorCtrl::GetInstance()->SetConsoleColor(CNSL_WHITE);
 	ConsoleColorCtrl::Destroy();
 
@@ -5,19 +5,34 @@
 #include <algorithm>
 #include <sstream>
 #include <memory>
+#include <cfloat>
 #define NOMINMAX  //for directx
 
+// The hardware rasterizer needs the Windows SDK. DISABLE_DIRECTX builds the software rasterizer only (headless runs on Linux/CI)
+#if !defined(_WIN32) && !defined(DISABLE_DIRECTX)
+#define DISABLE_DIRECTX
+#endif
+
 // SDL Headers
 #include "SDL.h"
-#include "SDL_syswm.h"
 #include "SDL_surface.h"
 #include "SDL_image.h"
 
+#ifndef DISABLE_DIRECTX
+#include "SDL_syswm.h"
+
 // DirectX Headers
 #include <dxgi.h>
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
+#else
+struct ID3D11Device; // Meshes & textures still take one, always nullptr without DirectX
+#endif
+
+#ifdef _WIN32
+#include <windows.h> // Console colors
+#endif
 
 // Framework Headers
 #include "Timer.h"